@@ -0,0 +1,550 @@
+#pragma once
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <utility>
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+#include "Bytecode.h"
+#include "Interpreter.h"
+#include "Separator.h"
+/*!
+* \file
+* \brief      
+*
+*     , .  main
+*/
+
+/*!
+ * @brief    
+ * @return      
+*/
+double PeakMemory() {
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS counters;
+  GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+  return static_cast<double>(counters.PeakWorkingSetSize) / (1 << 20);
+#else
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return static_cast<double>(usage.ru_maxrss) / 1024;
+#endif
+}
+
+/*!
+ * @brief    
+ * @param file_name    ,   
+ * @param repeats    
+ * @param threads   
+ *     ,        .
+ *        threads ,    
+*/
+void BenchmarkLexer(const std::string& file_name, int repeats,
+                    unsigned threads) {
+  MappedFile text(file_name);
+
+  double single_time = 0;
+  for (unsigned now : {1u, threads}) {
+    Separator sep;
+    sep.set_threads(now);
+    size_t lexemes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; ++i) {
+      sep.Split(text.data(), text.data() + text.size());
+      lexemes += sep.lexemes().size();
+    }
+    std::chrono::duration<double> time =
+        std::chrono::steady_clock::now() - start;
+    if (now == 1) single_time = time.count();
+
+    double megabytes = static_cast<double>(text.size()) * repeats / (1 << 20);
+    std::cout << "lexer, " << now << " threads: " << megabytes << " MB, "
+              << lexemes << " lexemes in " << time.count() << " s, "
+              << megabytes / time.count() << " MB/s, speedup "
+              << single_time / time.count() << "\n";
+    if (threads == 1) break;
+  }
+}
+
+/*!
+ * @brief ,       ,      -  
+ * @tparam Compiler  
+ * @return true,    
+*/
+template <class Compiler>
+bool CheckLexer() {
+  struct Case {
+    const char* text;       ///<  
+    int type;               ///<   , -1 -  
+    const char* last;       ///<   
+  };
+  const Case cases[] = {
+      {"int main(){ out(\"x\"); return 0; }", CurlyBraces, "}"},
+      {"out(\"ab\"", StringLit, "ab"},
+      {"/* c */ y", Id, "y"},
+      {"int main(){ out(\"x); return 0; }", -1, "x); return 0; }"},
+      {"int main(){ return 0; } /* open", -1, "/* open"},
+      {"int main(){ return 0; } /* open *", -1, "/* open *"},
+      {"x 1a", -1, "1a"},
+  };
+  bool ok = true;
+  for (const Case& now : cases) {
+    std::string text = now.text;
+    Separator sep;
+    sep.Split(text.data(), text.data() + text.size());
+    const TokenBuffer& lexemes = sep.lexemes();
+    bool passed = lexemes.size() > 0 &&
+                  lexemes.type(lexemes.size() - 1) == now.type &&
+                  lexemes.text(lexemes.size() - 1) == now.last;
+    if (passed && now.type == -1) {
+      try {
+        Compiler compiler(std::move(sep.lexemes()));
+        compiler.Program();
+        passed = false;
+      } catch (std::invalid_argument&) {
+      }
+    }
+    std::cout << (passed ? "ok: " : "failed: ") << text << "\n";
+    ok = ok && passed;
+  }
+  return ok;
+}
+
+/*!
+ * @brief         
+ *  ,     -    
+ * 
+ * @param globals   
+ * @param depth     main
+ * @return  
+ *         
+ *    ,     - 
+*/
+std::string ScopesProgram(int globals, int depth) {
+  std::string text;
+  for (int i = 0; i < globals; ++i) {
+    text += "int g" + std::to_string(i) + " = " + std::to_string(i) + ";\n";
+  }
+  text += "int main() {\n";
+  for (int level = 0; level < depth; ++level) {
+    std::string local = "l" + std::to_string(level);
+    text += "{ int " + local + " = " + std::to_string(level) + ";\n";
+    for (int i = level; i < globals; i += globals / 8 + 1) {
+      std::string global = "g" + std::to_string(i);
+      text += global + " = " + global + " + " + local + ";\n";
+    }
+  }
+  for (int i = 0; i < globals; ++i) {
+    std::string global = "g" + std::to_string(i);
+    text += global + " = " + global + " + l0;\n";
+  }
+  text += std::string(depth, '}') + "\nreturn 0;\n}\n";
+  return text;
+}
+
+/*!
+ * @brief      
+ * @param funcs  
+ * @return  
+ *       
+*/
+std::string FunctionsProgram(int funcs) {
+  std::string text = "int f0(int x, int y) { return x + y; }\n";
+  for (int i = 1; i < funcs; ++i) {
+    text += "int f" + std::to_string(i) + "(int x, int y) {\n  f" +
+            std::to_string(i - 1) + "(x, y);\n  f" + std::to_string(i / 2) +
+            "(y, x);\n  f" + std::to_string(i / 3) +
+            "(x, 1);\n  return x + y;\n}\n";
+  }
+  text += "int main() {\n  f" + std::to_string(funcs - 1) +
+          "(1, 2);\n  return 0;\n}\n";
+  return text;
+}
+
+/*!
+ * @brief       
+ * @tparam Compiler  
+ * @param name  
+ * @param text  
+ * @param repeats    
+ *         .   
+ *     : ,   , 
+ *   
+*/
+template <class Compiler>
+void BenchmarkCompile(const std::string& name, const std::string& text,
+                      int repeats) {
+  double time = 0;
+  size_t lexemes = 0;
+  for (int i = 0; i < repeats; ++i) {
+    Separator sep;
+    sep.Split(text.data(), text.data() + text.size());
+    lexemes += sep.lexemes().size();
+    auto start = std::chrono::steady_clock::now();
+    Compiler compiler(std::move(sep.lexemes()));
+    compiler.Program();
+    std::chrono::duration<double> now = std::chrono::steady_clock::now() - start;
+    time += now.count();
+  }
+
+  std::cout << name << ": " << lexemes << " lexemes in " << time << " s, "
+            << lexemes / time / 1e6 << " M lexemes/s, peak memory "
+            << PeakMemory() << " MB\n";
+}
+
+/*!
+ * @brief         
+ * @param lines  
+ * @return  
+ *          
+*/
+std::string ExpressionsProgram(int lines) {
+  std::string text =
+      "int main() {\n  int a = 1;\n  int b = 2;\n  int c = 3;\n  int d = 4;\n";
+  const char* names[] = {"a", "b", "c", "d"};
+  for (int i = 0; i < lines; ++i) {
+    std::string x = names[i % 4], y = names[(i + 1) % 4],
+                z = names[(i + 2) % 4], n = std::to_string(i % 97 + 1);
+    text += "  " + x + " = (" + y + " + " + n + ") * " + z + " - " + y +
+            " / " + n + " % 7 + " + x + " ** 2 < " + z + " == " + y +
+            " >= -" + n + " && !" + z + " || " + x + " != " + n + ";\n";
+  }
+  text += "  return a;\n}\n";
+  return text;
+}
+
+/*!
+ * @brief       
+ * @param lines  
+ * @return  
+ *   -  ,  -   4 ,
+ *  -  main.      
+ *   ,     
+*/
+std::string StressProgram(int lines) {
+  int globals = std::max(lines / 4, 1), funcs = std::max(lines / 8, 1);
+  std::string text;
+  text.reserve(static_cast<size_t>(lines) * 24);
+  for (int i = 0; i < globals; ++i) {
+    text += "int g" + std::to_string(i) + " = " + std::to_string(i % 100) +
+            ";\n";
+  }
+  for (int i = 0; i < funcs; ++i) {
+    std::string g = "g" + std::to_string(i % globals);
+    text += "int f" + std::to_string(i) + "(int x) {\n  " + g + " = " + g +
+            " + x;\n  return x * 2;\n}\n";
+  }
+  text += "int main() {\n";
+  for (int i = 0; i < lines - globals - funcs * 4 - 3; ++i) {
+    if (i % 2) {
+      text += "  f" + std::to_string(i % funcs) + "(" + std::to_string(i) +
+              ");\n";
+    } else {
+      std::string g = "g" + std::to_string(i % globals);
+      text += "  " + g + " += " + std::to_string(i % 7) + ";\n";
+    }
+  }
+  text += "  return 0;\n}\n";
+  return text;
+}
+
+//!      1M , 
+constexpr double kStressSeconds = 5;
+//!      1M , 
+constexpr double kStressMegabytes = 512;
+
+/*!
+ * @brief  :      lines 
+ * @tparam Compiler  
+ * @param lines  
+ * @return true,     
+ *  kStressSeconds  kStressMegabytes   1M  
+ *   lines
+*/
+template <class Compiler>
+bool StressCompile(int lines) {
+  std::string text = StressProgram(lines);
+  auto start = std::chrono::steady_clock::now();
+  Separator sep;
+  sep.Split(text.data(), text.data() + text.size());
+  size_t lexemes = sep.lexemes().size();
+  Compiler compiler(std::move(sep.lexemes()));
+  compiler.Program();
+  std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+
+  double scale = std::max(lines / 1e6, 0.01), memory = PeakMemory();
+  bool ok = time.count() <= kStressSeconds * scale &&
+            memory <= kStressMegabytes * scale;
+  std::cout << "stress: " << lines << " lines, " << lexemes << " lexemes in "
+            << time.count() << " s, peak memory " << memory << " MB, "
+            << (ok ? "within budget" : "over budget") << "\n";
+  return ok;
+}
+
+/*!
+ * @brief        
+ * @param iterations   
+ * @return  
+*/
+std::string DispatchProgram(int iterations) {
+  return "int main() {\n  int i = 0;\n  int s = 0;\n  while (i < " +
+         std::to_string(iterations) +
+         ") {\n    s = s + i % 7 * 2 - 1;\n    i += 1;\n  }\n  return s;\n}\n";
+}
+
+/*!
+ * @brief      
+ * @param code - 
+ * @return         
+ *      
+*/
+int LoopOps(const Bytecode& code) {
+  for (size_t pos = 0; pos < code.size();
+       pos += 1 + 4 * OperandCount(code.op(pos))) {
+    if (code.op(pos) != OpCodes::Jump || code.operand(pos + 1) >= pos) continue;
+    int ops = 0;
+    for (size_t cur = code.operand(pos + 1); cur <= pos;
+         cur += 1 + 4 * OperandCount(code.op(cur))) {
+      ++ops;
+    }
+    return ops;
+  }
+  return 0;
+}
+
+/*!
+ * @brief   repeats 
+ * @tparam kThreaded   goto
+ * @tparam Compiler  
+ * @param compiler    
+ * @param repeats    
+ * @return    
+*/
+template <bool kThreaded, class Compiler>
+double MeasureDispatch(Compiler& compiler, int repeats) {
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < repeats; ++i) {
+    compiler.template Run<kThreaded>();
+  }
+  std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+  return time.count();
+}
+
+/*!
+ * @brief        switch    goto
+ * @tparam Compiler  
+ * @param iterations     
+ * @param repeats    
+*/
+template <class Compiler>
+void BenchmarkDispatch(int iterations, int repeats) {
+  std::string text = DispatchProgram(iterations);
+  Separator sep;
+  sep.Split(text.data(), text.data() + text.size());
+  Compiler compiler(std::move(sep.lexemes()));
+  compiler.Program();
+  double ops = static_cast<double>(LoopOps(compiler.poliz())) * iterations *
+               repeats;
+
+  double time = MeasureDispatch<false>(compiler, repeats);
+  std::cout << "dispatch, switch: " << ops << " ops in " << time << " s, "
+            << ops / time / 1e6 << " M ops/s\n";
+#if DC_COMPUTED_GOTO
+  time = MeasureDispatch<true>(compiler, repeats);
+  std::cout << "dispatch, computed goto: " << ops << " ops in " << time
+            << " s, " << ops / time / 1e6 << " M ops/s\n";
+#else
+  std::cout << "dispatch, computed goto: disabled in this build\n";
+#endif
+}
+
+/*!
+ * @brief     ,      ,      
+ * @tparam Compiler  
+ * @param iterations     
+ * @param repeats    
+ *     int,             
+*/
+template <class Compiler>
+void BenchmarkTyped(int iterations, int repeats) {
+  std::string text = DispatchProgram(iterations);
+  double generic_time = 0;
+  for (bool typed : {false, true}) {
+    Separator sep;
+    sep.Split(text.data(), text.data() + text.size());
+    Compiler compiler(std::move(sep.lexemes()));
+    compiler.set_typed_ops(typed);
+    compiler.Program();
+    double ops = static_cast<double>(LoopOps(compiler.poliz())) * iterations *
+                 repeats;
+
+    double time = MeasureDispatch<DC_COMPUTED_GOTO != 0>(compiler, repeats);
+    std::cout << (typed ? "typed ops: " : "generic ops: ") << ops
+              << " ops in " << time << " s, " << ops / time / 1e6
+              << " M ops/s";
+    if (typed) {
+      std::cout << ", " << generic_time / time << "x faster";
+    } else {
+      generic_time = time;
+    }
+    std::cout << "\n";
+  }
+}
+
+/*!
+ * @brief    ,     &&    
+ * @param iterations   
+ * @return  
+*/
+std::string ShortCircuitProgram(int iterations) {
+  return "int main() {\n  int i = 0;\n  int s = 0;\n  while (i < " +
+         std::to_string(iterations) +
+         ") {\n    if (i % 8 == 0 && (i / 3 + s * 7) % 5 == 1) s = s + 1;\n"
+         "    i += 1;\n  }\n  return s;\n}\n";
+}
+
+/*!
+ * @brief    &&        
+ * @tparam Compiler  
+ * @param iterations     
+ * @param repeats    
+ *       ,    
+*/
+template <class Compiler>
+void BenchmarkShortCircuit(int iterations, int repeats) {
+  std::string text = ShortCircuitProgram(iterations);
+  double full_time = 0;
+  for (bool short_circuit : {false, true}) {
+    Separator sep;
+    sep.Split(text.data(), text.data() + text.size());
+    Compiler compiler(std::move(sep.lexemes()));
+    compiler.set_short_circuit(short_circuit);
+    compiler.Program();
+
+    double time = MeasureDispatch<DC_COMPUTED_GOTO != 0>(compiler, repeats);
+    std::cout << (short_circuit ? "short circuit: " : "both operands: ")
+              << iterations << " iterations x " << repeats << " in " << time
+              << " s";
+    if (short_circuit) {
+      std::cout << ", " << full_time / time << "x faster";
+    } else {
+      full_time = time;
+    }
+    std::cout << "\n";
+  }
+}
+
+//!        , 
+constexpr double kLoopGrowthMegabytes = 1;
+
+/*!
+ * @brief    ,       
+ * @param iterations   
+ * @return  
+ *   ,  iterations   ,     
+*/
+std::string StringLoopProgram(int iterations) {
+  return "int main() {\n  int i = 0;\n  string s = \"\";\n  while (i < " +
+         std::to_string(iterations) +
+         ") {\n    ((s + i % 100) + (i / 100) % 100) + (i / 10000) % 100;\n"
+         "    i += 1;\n  }\n  return 0;\n}\n";
+}
+
+/*!
+ * @brief        ,    
+ * @tparam Compiler  
+ * @param name    
+ * @param text  
+ * @param iterations   
+ * @return true,           kLoopGrowthMegabytes
+*/
+template <class Compiler>
+bool StressProgram(const std::string& name, const std::string& text,
+                   int iterations) {
+  Separator sep;
+  sep.Split(text.data(), text.data() + text.size());
+  Compiler compiler(std::move(sep.lexemes()));
+  compiler.Program();
+  double ops = static_cast<double>(LoopOps(compiler.poliz())) * iterations;
+
+  double before = PeakMemory();
+  double time = MeasureDispatch<DC_COMPUTED_GOTO != 0>(compiler, 1);
+  double growth = PeakMemory() - before;
+  bool ok = growth <= kLoopGrowthMegabytes;
+  std::cout << name << ": " << iterations << " iterations, " << ops
+            << " ops in " << time << " s, " << ops / time / 1e6
+            << " M ops/s, memory growth " << growth << " MB, "
+            << (ok ? "flat" : "growing") << "\n";
+  return ok;
+}
+
+/*!
+ * @brief  ,     -
+ * @param literals  
+ * @param seed ,     ,      seed   
+ * @return  
+*/
+std::string LiteralsProgram(int literals, int seed) {
+  std::string res = "int main() {\n  string s;\n";
+  for (int i = 0; i < literals; ++i) {
+    res += "  s = \"literal " + std::to_string(seed) + " " + std::to_string(i) +
+           " of a program compiled in a loop\";\n";
+  }
+  return res + "  return 0;\n}\n";
+}
+
+/*!
+ * @brief   programs      ,    
+ * @tparam Compiler  
+ * @param programs  
+ * @return true,        ,   kLoopGrowthMegabytes
+ *            
+*/
+template <class Compiler>
+bool StressPrograms(int programs) {
+  constexpr int kLiterals = 2000;
+  double before = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < programs; ++i) {
+    std::string text = LiteralsProgram(kLiterals, i);
+    Separator sep;
+    sep.Split(text.data(), text.data() + text.size());
+    Compiler compiler(std::move(sep.lexemes()));
+    compiler.Program();
+    if (i == 0) before = PeakMemory();
+  }
+  std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+  double growth = PeakMemory() - before;
+  bool ok = growth <= kLoopGrowthMegabytes;
+  std::cout << "stress programs: " << programs << " programs, " << kLiterals
+            << " literals each in " << time.count()
+            << " s, memory growth " << growth << " MB, "
+            << (ok ? "flat" : "growing") << "\n";
+  return ok;
+}
+
+/*!
+ * @brief   :   , ,  ,     
+ * @tparam Compiler  
+ * @param iterations     
+ * @param string_iterations     
+ * @param programs   
+ * @return true,        
+ *        ,      ,        .      ,         
+*/
+template <class Compiler>
+bool StressLoop(int iterations, int string_iterations, int programs) {
+  bool ok = StressProgram<Compiler>("stress loop", DispatchProgram(iterations),
+                                    iterations);
+  ok = StressProgram<Compiler>("stress string loop",
+                               StringLoopProgram(string_iterations),
+                               string_iterations) &&
+       ok;
+  return StressPrograms<Compiler>(programs) && ok;
+}
@@ -0,0 +1,348 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Poliz.h"
+/*!
+ * \file
+ * \brief      -
+ */
+
+/*!
+ * @brief   -
+ *     ,     
+ */
+enum class OpCodes : uint8_t {
+  Nop,        ///<   
+  Var,        ///<     ,  -  
+  Local,      ///<     ,  -   
+  Const,      ///<    ,  -  
+  Jump,       ///<  ,  - 
+  JumpFalse,  ///<   ,  - 
+  Call,       ///<  ,  - -    
+  Return,     ///<   
+  In,         ///< 
+  Out,        ///< 
+  PostInc,    ///<  ++
+  PostDec,    ///<  --
+  PostNot,    ///<  !
+  Index,      ///<  
+  PreInc,     ///<  ++
+  PreDec,     ///<  --
+  PreNot,     ///<  !
+  UnPlus,     ///<  +
+  UnMinus,    ///<  -
+  Pow,        ///< **
+  Mul,        ///< *
+  Div,        ///< /
+  Mod,        ///< %
+  Add,        ///< +
+  Sub,        ///< -
+  Less,       ///< <
+  LessEq,     ///< <=
+  Greater,    ///< >
+  GreaterEq,  ///< >=
+  Eq,         ///< ==
+  Ne,         ///< !=
+  And,        ///< &&
+  Or,         ///< ||
+  Assign,     ///< =
+  AddAssign,  ///< +=
+  SubAssign,  ///< -=
+  MulAssign,  ///< *=
+  DivAssign,  ///< /=
+  ModAssign,  ///< %=
+  Comma,      ///< ,
+  Pop,        ///< ; -     
+  //   ,     . 
+  //   :      
+  AddInt,          ///< +  int
+  SubInt,          ///< -  int
+  MulInt,          ///< *  int
+  DivInt,          ///< /  int
+  ModInt,          ///< %  int
+  LessInt,         ///< <  int
+  LessEqInt,       ///< <=  int
+  GreaterInt,      ///< >  int
+  GreaterEqInt,    ///< >=  int
+  EqInt,           ///< ==  int
+  NeInt,           ///< !=  int
+  AssignInt,       ///< =  int  int
+  AddAssignInt,    ///< +=  int  int
+  SubAssignInt,    ///< -=  int  int
+  AddFloat,        ///< +  float
+  SubFloat,        ///< -  float
+  MulFloat,        ///< *  float
+  DivFloat,        ///< /  float
+  ModFloat,        ///< %  float
+  LessFloat,       ///< <  float
+  LessEqFloat,     ///< <=  float
+  GreaterFloat,    ///< >  float
+  GreaterEqFloat,  ///< >=  float
+  EqFloat,         ///< ==  float
+  NeFloat,         ///< !=  float
+  AssignFloat,     ///< =  float  float
+  AddAssignFloat,  ///< +=  float  float
+  SubAssignFloat,  ///< -=  float  float
+  Concat,          ///< +  
+  ToFloat,         ///<  int  float,  -     (0 - )
+  Cast,            ///<     ,   ,  - 
+  //   &&  ||     
+  AndJump,  ///<     &&:      ,   .  - 
+  OrJump,   ///<     ||:      ,   .  - 
+  Count
+};
+
+//!     OpCodes -      
+constexpr std::string_view kOpCodeNames[static_cast<int>(OpCodes::Count)] = {
+    "nop",   "var",    "local",  "const", "B!",    "F!",    "call",   "return",
+    "in",    "out",    "post++", "post--", "post!", "[]",   "pre++",  "pre--",
+    "pre!",  "un+",    "un-",    "**",    "*",     "/",     "%",      "+",
+    "-",     "<",      "<=",     ">",     ">=",    "==",    "!=",     "&&",
+    "||",    "=",      "+=",     "-=",    "*=",    "/=",    "%=",     ",",
+    ";",     "+i",     "-i",     "*i",    "/i",    "%i",    "<i",     "<=i",
+    ">i",    ">=i",    "==i",    "!=i",   "=i",    "+=i",   "-=i",    "+f",
+    "-f",    "*f",     "/f",     "%f",    "<f",    "<=f",   ">f",     ">=f",
+    "==f",   "!=f",    "=f",     "+=f",   "-=f",   "concat", "tofloat",
+    "cast",  "F&&",    "T||"};
+
+/*!
+ * @brief        
+ * @param name  
+ * @return    OpCodes::Nop,    
+ */
+inline OpCodes ToOpCode(std::string_view name) {
+  for (int i = static_cast<int>(OpCodes::Return);
+       i < static_cast<int>(OpCodes::Count); ++i) {
+    if (kOpCodeNames[i] == name) return static_cast<OpCodes>(i);
+  }
+  return OpCodes::Nop;
+}
+
+/*!
+ * @brief    
+ * @param op  
+ * @return true,    -  
+ */
+constexpr bool IsJump(OpCodes op) {
+  return op == OpCodes::Jump || op == OpCodes::JumpFalse ||
+         op == OpCodes::AndJump || op == OpCodes::OrJump;
+}
+
+/*!
+ * @brief   
+ * @param op  
+ * @return  4-    
+ */
+constexpr int OperandCount(OpCodes op) {
+  return op == OpCodes::Call ? 2
+         : op == OpCodes::Var || op == OpCodes::Local ||
+                 op == OpCodes::Const || IsJump(op) ||
+                 op == OpCodes::ToFloat || op == OpCodes::Cast
+             ? 1
+             : 0;
+}
+
+/*!
+ * @brief     
+ * @param op      
+ * @param type   ,   -    
+ * @return       op,      
+ */
+constexpr OpCodes TypedOpCode(OpCodes op, VarTypes type) {
+  if (type == String) return op == OpCodes::Add ? OpCodes::Concat : op;
+  if (type != Int && type != Float) return op;
+  bool ints = type == Int;
+  switch (op) {
+    case OpCodes::Add:
+      return ints ? OpCodes::AddInt : OpCodes::AddFloat;
+    case OpCodes::Sub:
+      return ints ? OpCodes::SubInt : OpCodes::SubFloat;
+    case OpCodes::Mul:
+      return ints ? OpCodes::MulInt : OpCodes::MulFloat;
+    case OpCodes::Div:
+      return ints ? OpCodes::DivInt : OpCodes::DivFloat;
+    case OpCodes::Mod:
+      return ints ? OpCodes::ModInt : OpCodes::ModFloat;
+    case OpCodes::Less:
+      return ints ? OpCodes::LessInt : OpCodes::LessFloat;
+    case OpCodes::LessEq:
+      return ints ? OpCodes::LessEqInt : OpCodes::LessEqFloat;
+    case OpCodes::Greater:
+      return ints ? OpCodes::GreaterInt : OpCodes::GreaterFloat;
+    case OpCodes::GreaterEq:
+      return ints ? OpCodes::GreaterEqInt : OpCodes::GreaterEqFloat;
+    case OpCodes::Eq:
+      return ints ? OpCodes::EqInt : OpCodes::EqFloat;
+    case OpCodes::Ne:
+      return ints ? OpCodes::NeInt : OpCodes::NeFloat;
+    case OpCodes::Assign:
+      return ints ? OpCodes::AssignInt : OpCodes::AssignFloat;
+    case OpCodes::AddAssign:
+      return ints ? OpCodes::AddAssignInt : OpCodes::AddAssignFloat;
+    case OpCodes::SubAssign:
+      return ints ? OpCodes::SubAssignInt : OpCodes::SubAssignFloat;
+    default:
+      return op;
+  }
+}
+
+/*!
+ * @brief         
+ * @param op  
+ * @return  ,  TypedOpCode   op,   op
+ */
+constexpr OpCodes GenericOpCode(OpCodes op) {
+  for (int i = static_cast<int>(OpCodes::Pow);
+       i <= static_cast<int>(OpCodes::SubAssign); ++i) {
+    OpCodes generic = static_cast<OpCodes>(i);
+    if (TypedOpCode(generic, Int) == op || TypedOpCode(generic, Float) == op ||
+        TypedOpCode(generic, String) == op) {
+      return generic;
+    }
+  }
+  return op;
+}
+
+/*!
+ * \brief    -
+ *
+ *  -   :         4 .
+ *       -    . 
+ *    ,      
+ *  ,   -    TIDTree,   
+ *   .    ,  
+ * ,    ,   -
+ *
+ *          , 
+ *   ,   .      
+ *      
+ */
+class Bytecode {
+ public:
+  /*!
+   * @brief   
+   */
+  Bytecode() {}
+  /*!
+   * @brief      
+   * @param code  ,   ,   
+   * @param size    
+   */
+  Bytecode(const uint8_t* code, size_t size) : view_(code), view_size_(size) {}
+  /*!
+   * @brief    
+   * @param op  
+   */
+  void Emit(OpCodes op) { code_.push_back(static_cast<uint8_t>(op)); }
+  /*!
+   * @brief     
+   * @param op  
+   * @param operand 
+   */
+  void Emit(OpCodes op, uint32_t operand) {
+    Emit(op);
+    EmitOperand(operand);
+  }
+  /*!
+   * @brief     
+   * @param op  
+   * @param first  
+   * @param second  
+   */
+  void Emit(OpCodes op, uint32_t first, uint32_t second) {
+    Emit(op);
+    EmitOperand(first);
+    EmitOperand(second);
+  }
+  /*!
+   * @brief    ,    
+   * @param pos    
+   * @param operand   
+   */
+  void Patch(size_t pos, uint32_t operand) {
+    std::memcpy(&code_[pos], &operand, sizeof(operand));
+  }
+  /*!
+   * @brief     
+   * @param data  
+   * @return  
+   */
+  uint32_t AddConst(const VarData& data) {
+    consts_.push_back(data);
+    return static_cast<uint32_t>(consts_.size() - 1);
+  }
+
+  /*!
+   * @brief    
+   */
+  OpCodes op(size_t pos) const { return static_cast<OpCodes>(data()[pos]); }
+  /*!
+   * @brief   
+   */
+  uint32_t operand(size_t pos) const {
+    uint32_t res;
+    std::memcpy(&res, data() + pos, sizeof(res));
+    return res;
+  }
+  /*!
+   * @brief    ,     
+   */
+  size_t size() const { return view_ ? view_size_ : code_.size(); }
+  /*!
+   * @brief  
+   */
+  const uint8_t* data() const { return view_ ? view_ : code_.data(); }
+  const std::vector<VarData>& consts() const { return consts_; }
+  /*!
+   * @brief   
+   */
+  StringHeap& strings() { return strings_; }
+  const StringHeap& strings() const { return strings_; }
+
+  /*!
+   * @brief     ,    
+   * @param os  
+   * @param func_names    .        
+   */
+  void Disassemble(std::ostream& os,
+                   const std::vector<std::string>& func_names = {}) const {
+    for (size_t pos = 0; pos < size();) {
+      OpCodes cur = op(pos);
+      os << pos << ": " << kOpCodeNames[static_cast<int>(cur)];
+      size_t arg = pos + 1;
+      if (cur == OpCodes::Const) {
+        const VarData& data = consts_[operand(arg)];
+        os << ' ' << ToString(data.type_) << ' ';
+        Print(os, data, strings_);
+      } else if (cur == OpCodes::Call) {
+        uint32_t func = operand(arg + 4);
+        os << ' '
+           << (func < func_names.size() ? func_names[func]
+                                        : '#' + std::to_string(func))
+           << ' ' << operand(arg);
+      } else if (cur == OpCodes::Cast) {
+        os << ' ' << ToString(static_cast<VarTypes>(operand(arg)));
+      } else if (OperandCount(cur) == 1) {
+        os << ' ' << operand(arg);
+      }
+      os << '\n';
+      pos = arg + 4 * OperandCount(cur);
+    }
+  }
+
+ private:
+  void EmitOperand(uint32_t operand) {
+    code_.resize(code_.size() + sizeof(operand));
+    Patch(code_.size() - sizeof(operand), operand);
+  }
+
+  std::vector<uint8_t> code_;    ///< 
+  const uint8_t* view_ = nullptr;  ///<  ,    
+  size_t view_size_ = 0;           ///<   
+  std::vector<VarData> consts_;  ///<  
+  StringHeap strings_;           ///<   
+};
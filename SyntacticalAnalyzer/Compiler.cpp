@@ -9,9 +9,14 @@
 #include "TypeStack.h"
 #include "TID.h"
 #include "Lexeme.h"
+#include "TokenBuffer.h"
 #include "ComponentsInfo.h"
 #include "Poliz.h"
+#include "Bytecode.h"
 #include "Interpreter.h"
+#include "Optimizer.h"
+#include "ProgramFile.h"
+#include "Benchmark.h"
 /*!
 * \file
 * \brief Основной файл, содержащий описание класса транслятора и запускает компиляцию кода
@@ -20,65 +25,36 @@
 /*!
 * Функция проверяет, можно ли привести один тип к другому
 */
-bool CompareTypes(std::string lhs, std::string rhs) {
-  if (lhs[0] == 'a') lhs.erase(lhs.begin());
-  if (rhs[0] == 'a') rhs.erase(rhs.begin());
+bool CompareTypes(TypeDesc lhs, TypeDesc rhs) {
+  if (lhs.kind == ValueKinds::Lvalue) lhs.kind = ValueKinds::Value;
+  if (rhs.kind == ValueKinds::Lvalue) rhs.kind = ValueKinds::Value;
   if (lhs == rhs) return true;
-  if (lhs != "int" && lhs != "bool" && lhs != "string" && lhs != "float" &&
-      lhs != "char")
-    return false;
-  if (rhs != "int" && rhs != "bool" && rhs != "string" && rhs != "float" &&
-      rhs != "char")
-    return false;
-
-  if (lhs == "string" && rhs != "string" ||
-      lhs != "string" && rhs == "string" || lhs[0] == 'l' || rhs[0] == 'l') {
+  if (!IsStandardType(lhs.base) || !IsStandardType(rhs.base) ||
+      lhs.kind == ValueKinds::List || rhs.kind == ValueKinds::List) {
     return false;
   }
-  return true;
+
+  return (lhs.base == BaseTypes::String) == (rhs.base == BaseTypes::String);
 }
 
 /*!
 * \brief Класс транслятора
 * 
-* Класс, отвечающий за синтаксический и семантический анализ, а также генерацию кода (ПОЛИЗ) для интерпретатора. Принимает на вход два файла - последовательность лексем ("separated.txt") и список операций с указанием приоритета ("operations.txt")
+* Класс, отвечающий за синтаксический и семантический анализ, а также генерацию кода (ПОЛИЗ) для интерпретатора. Принимает на вход последовательность лексем от лексического анализатора
 * Все функции без описания используются для анализа соответствующих элементов языка из грамматики
 */
 class Compiler {
  public:
   /*!
-   * @brief Конструктор класса компилятора по файлу лексем и списка операций с
-   * приоритетами
-   * @param lexemes_filename Имя файла с последовательностью лексем
-   * @param opers_filename Имя файла с операциями и их приоритетами
+   * @brief Конструктор класса компилятора по массиву лексем
+   * @param lexemes Лексемы, полученные от лексического анализатора. Типы
+   * операций уже заменены на их приоритеты
    */
-  Compiler(const std::string& lexemes_filename,
-           const std::string& opers_filename)
-      : cur_ind_(-1) {
-    std::ifstream in(lexemes_filename);
-    while (!in.eof()) {
-      int type, line;
-      std::string text;
-      in >> text >> type >> line;
-      if (text == "") break;
-      if (text == "true" || text == "false") {
-        type = 23;
-      } else if (type == 4 || type == 9) {
-        std::ifstream in_op(opers_filename);
-        int cur_type;
-        while (!in_op.eof()) {
-          std::string tmp;
-          in_op >> tmp;
-          if (std::isdigit(tmp[0])) {
-            cur_type = std::stoi(tmp);
-          } else if (tmp == text) {
-            type = cur_type + 12;
-            break;
-          }
-        }
-      }
-      lexemes_.emplace_back(static_cast<LexemeTypes>(type), text, line);
-    }
+  Compiler(TokenBuffer lexemes)
+      : lexemes_(std::move(lexemes)),
+        cur_ind_(-1),
+        tid_(lexemes_.symbol_table()),
+        stack_(lexemes_.symbol_table()) {
     PushLexeme();
   }
 
@@ -86,144 +62,219 @@ class Compiler {
    * Запускает компиляцию исходного кода
    */
   void Program() {
-    /* if (cur_ == "struct") {
-      Struct();
-      Program();
-    } else*/
-    if (lexemes_[cur_ind_ + 2] == "," || lexemes_[cur_ind_ + 2] == ";" ||
-        lexemes_[cur_ind_ + 2] == "=") {
-      VarDefinition();
-      Program();
-    } else if (cur_ == "int" && lexemes_[cur_ind_ + 1] == "main" &&
-               lexemes_[cur_ind_ + 2] == "(") {
-      PushLexeme(), PushLexeme(), PushLexeme();
-      cur_func.set_type("int");
-      if (cur_ != ")") {
-        throw std::invalid_argument("error in lexeme " + cur_.text() +
-                                    " in line " + std::to_string(cur_.line()));
+    // определения верхнего уровня разбираются в цикле до функции main, чтобы
+    // глубина стека не зависела от их количества
+    while (true) {
+      /* if (cur_ == "struct") {
+        Struct();
+      } else*/
+      if (lexemes_[cur_ind_ + 2] == "," || lexemes_[cur_ind_ + 2] == ";" ||
+          lexemes_[cur_ind_ + 2] == "=") {
+        VarDefinition();
+      } else if (cur_ == "int" && lexemes_[cur_ind_ + 1] == "main" &&
+                 lexemes_[cur_ind_ + 2] == "(") {
+        PushLexeme(), PushLexeme(), PushLexeme();
+        cur_func.set_type(TypeDesc(BaseTypes::Int));
+        if (cur_ != ")") {
+          throw std::invalid_argument("error in lexeme " +
+                                      std::string(cur_.text()) + " in line " +
+                                      std::to_string(cur_.line()));
+        }
+        PushLexeme();
+        poliz_start_ind_ = poliz_.size();
+        Block();
+        break;
+      } else if (lexemes_[cur_ind_ + 2] == "(") {
+        funcs_.Add(Func());
+        cur_func = FunctionInfo();
+      } else {
+        throw std::invalid_argument("error in lexeme " +
+                                    std::string(cur_.text()) + " in line " +
+                                    std::to_string(cur_.line()));
       }
-      PushLexeme();
-      poliz_start_ind_ = poliz_.size();
-      Block();
-    } else if (lexemes_[cur_ind_ + 2] == "(") {
-      funcs_.push_back(Func());
-      cur_func = FunctionInfo();
-      Program();
-    } else {
-      throw std::invalid_argument("error in lexeme " + cur_.text() +
-                                  " in line " + std::to_string(cur_.line()));
     }
-    if (cur_ind_ != lexemes_.size() - 1) {
-      throw std::invalid_argument("error in lexeme " + cur_.text() +
-                                  " in line " + std::to_string(cur_.line()));
+    // на последней лексеме PushLexeme не сдвигается, поэтому после main
+    // текущей должна остаться ее закрывающая скобка, иначе за ней что-то есть,
+    // например незакрытые строка или комментарий
+    if (!AtEnd() || cur_ != "}") {
+      throw std::invalid_argument("error in lexeme " +
+                                  std::string(cur_.text()) + " in line " +
+                                  std::to_string(cur_.line()));
     }
   }
 
+  /*!
+   * @brief Сворачивает в ПОЛИЗе операции над литералами и подставляет литералы вместо переменных, которые изменяются один раз. Вызывается после Program()
+   * @return Итоги прохода, в том числе сколько операций удалено
+  */
+  OptimizeStats Optimize() {
+    Optimizer optimizer(poliz_, funcs_.items(), tid_.globals(),
+                        poliz_start_ind_);
+    return optimizer.Run();
+  }
+
   /*!
    * @brief Выводит ПОЛИЗ в необходимы файл
    * @param filename Файл, в который нужно вывести полиз
   */
   void WritePoliz(const std::string& filename) {
     std::ofstream stream(filename);
-    for (auto val : poliz_) {
-      if (val->type() == Variable) {
-        stream << "Var: " << dynamic_cast<PolizVar*>(val)->var();
-      }
-      else if (val->type()==Oper) {
-        stream << "Oper: " << dynamic_cast<PolizOper*>(val)->oper();
-      }
-      else if (val->type() == Address) {
-        stream << "Address: " << dynamic_cast<PolizAddress*>(val)->address();
-      } else if (val->type() == Lit) {
-        auto lit = dynamic_cast<PolizLit*>(val);
-        stream << ToString(lit->data_.type_) << " lit: ";
-        if (lit->data_.type_ == String) {
-          stream << lit->data_.string_;
-        } else if (lit->data_.type_ == Int) {
-          stream << lit->data_.int_;
-        } else if (lit->data_.type_ == Float) {
-          stream << lit->data_.float_;
-        } else if (lit->data_.type_ == Bool) {
-          stream << lit->data_.bool_;
-        } else if (lit->data_.type_ == Char) {
-          stream << lit->data_.char_;
-        }
-      }
-      else if (val->type() == PolizElemTypes::Func) {
-        stream << "Func call: "
-                  << dynamic_cast<PolizFuncCall*>(val)->func_name() << ' '
-                  << dynamic_cast<PolizFuncCall*>(val)->arguments();
-      }
-      stream << std::endl;
-    }
-    stream.close();
+    std::vector<std::string> names;
+    for (const FunctionInfo& func : funcs_.items()) names.push_back(func.name());
+    poliz_.Disassemble(stream, names);
+  }
+
+  /*!
+   * @brief Записывает оттранслированную программу в двоичный файл, который можно исполнить без повторной трансляции
+   * @param filename Файл, в который нужно записать программу
+  */
+  void WriteProgram(const std::string& filename) {
+    ProgramFile::Write(filename, poliz_, funcs_.items(), tid_.globals(),
+                       poliz_start_ind_);
   }
 
   /*!
    * @brief Запускает исполнение кода
   */
   void Launch() { 
-    Interpreter interpreter(funcs_, poliz_);
+    Interpreter interpreter(funcs_.items(), poliz_, tid_.globals());
     interpreter.Launch(poliz_start_ind_);
   }
+
+  /*!
+   * @brief Исполняет код и возвращается, когда main вернет значение
+   * @tparam kThreaded Выбирать операции через вычисляемый goto, а не через switch
+  */
+  template <bool kThreaded>
+  void Run() {
+    Interpreter interpreter(funcs_.items(), poliz_, tid_.globals());
+    interpreter.Run<kThreaded>(poliz_start_ind_);
+  }
+
+  /*!
+   * @brief Геттер poliz_
+   * @return ПОЛИЗ программы
+  */
+  const Bytecode& poliz() const { return poliz_; }
+  /*!
+   * @brief Выбирать ли для операций над int, float и строками операции этого типа. Задается до Program(); выключается, чтобы сравнить скорость с операциями над любыми типами
+   * @param typed_ops Выбирать операции по типу операндов
+  */
+  void set_typed_ops(bool typed_ops) { typed_ops_ = typed_ops; }
+  /*!
+   * @brief Вычислять ли && и || по короткой схеме. Задается до Program(); выключается, чтобы сравнить скорость с вычислением обоих операндов
+   * @param short_circuit Вычислять && и || по короткой схеме
+  */
+  void set_short_circuit(bool short_circuit) { short_circuit_ = short_circuit; }
  private:
-  std::vector<Lexeme>
-      lexemes_;  ///< Массив из лексем - по сути исходный код программы
+  TokenBuffer lexemes_;  ///< Буфер лексем - по сути исходный код программы
   Lexeme cur_;   ///< Текущая анализируемая лексема
   int cur_ind_;  ///< Индекс текущей анализируемой лексемы
-  std::vector<FunctionInfo> funcs_;  ///< Успешно считанные функции в программе
+  Registry<FunctionInfo> funcs_;  ///< Успешно считанные функции в программе
   TIDTree tid_;  ///< Дерево таблиц идентификаторов для контроля имен
   TypeStack stack_;  ///< Стек типов для контроля типов в выражениях
-  std::vector<StructInfo>
-      structs_;  ///< Массив успешно считанных структур программы
+  Registry<StructInfo> structs_;  ///< Успешно считанные структуры программы
   FunctionInfo cur_func;  ///< Текущая анализируемая функция
-  std::vector<PolizElem*> poliz_;  ///< ПОЛИЗ
+  Bytecode poliz_;  ///< ПОЛИЗ в виде байт-кода
   int poliz_start_ind_; ///< Индекс элемента ПОЛИЗа, с которого начинается исполнение программы
+  bool typed_ops_ = true; ///< Выбирать операции по типу операндов
+  bool short_circuit_ = true; ///< Вычислять && и || по короткой схеме
   std::stack<int> loops_starts_; ///< Индексы начал циклов в ПОЛИЗЕ. Верхний элемент стека - индекс начала текущего цикла
   std::stack<std::vector<int>> loops_breaks_to_fill_; ///< Индексы элементов полиза, куда нужно будет подставить индекс элемента, следующего после кода текущего цикла.
 
   /*!
    * @brief Добавить в конец полиза операцию
-   * @param oper Операция, которую надо добавить в полиз
+   * @param oper Код операции
   */
-  void PolizPush(std::string oper) { poliz_.push_back(new PolizOper(oper)); }
+  void PolizPush(OpCodes oper) { poliz_.Emit(oper); }
   /*!
-   * @brief Добавить адрес переменной в полиз
-   * @param var Адрес переменной который надо добавить
+   * @brief Добавить в конец полиза операцию по ее имени
+   * @param oper Имя операции, как оно пишется в тексте ПОЛИЗа
   */
-  void PolizPush(Var* var) { poliz_.push_back(new PolizVar(var)); }
+  void PolizPush(const std::string& oper) { poliz_.Emit(ToOpCode(oper)); }
   /*!
-   * @brief Добавить индекс элемента ПОЛИЗа в ПОЛИЗ
-   * @param address индес, который надо добавить
+   * @brief Добавить в ПОЛИЗ бинарную операцию, по возможности - для известного типа операндов
+   *
+   * Типы операндов известны из стека типов. Если оба операнда int, оба float или обе строки, добавляется операция для этого типа. Если один операнд int, а другой float, перед операцией над float int приводится операцией ToFloat. У присваиваний тип результата - тип переменной, поэтому приводится только значение
+   * @param oper Код операции
+   * @param lhs Тип левого операнда
+   * @param rhs Тип правого операнда
   */
-  void PolizPush(int address) { poliz_.push_back(new PolizAddress(address)); }
+  void PolizPush(OpCodes oper, TypeDesc lhs, TypeDesc rhs) {
+    OpCodes typed = oper;
+    if (typed_ops_ && lhs.kind != ValueKinds::List &&
+        rhs.kind != ValueKinds::List && IsStandardType(lhs.base) &&
+        IsStandardType(rhs.base)) {
+      bool assign = oper == OpCodes::Assign || oper == OpCodes::AddAssign ||
+                    oper == OpCodes::SubAssign;
+      if (lhs.base == rhs.base) {
+        typed = TypedOpCode(oper, ToVarType(lhs));
+      } else if (lhs.base == BaseTypes::Float && rhs.base == BaseTypes::Int) {
+        typed = TypedOpCode(oper, Float);
+        if (typed != oper) poliz_.Emit(OpCodes::ToFloat, 0);
+      } else if (lhs.base == BaseTypes::Int && rhs.base == BaseTypes::Float &&
+                 !assign) {
+        typed = TypedOpCode(oper, Float);
+        if (typed != oper) poliz_.Emit(OpCodes::ToFloat, 1);
+      }
+    }
+    poliz_.Emit(typed);
+  }
+  /*!
+   * @brief Добавить переменную в полиз
+   * @param row Элемент TID переменной, которую надо добавить
+  */
+  void PolizPush(const TIDRow& row) {
+    poliz_.Emit(row.local() ? OpCodes::Local : OpCodes::Var, row.slot());
+  }
   /*!
    * @brief Добавить литерал в ПОЛИЗ
-   * @param lit Литерал, который надо добавить в полиз
+   * @param data Значение литерала, который надо добавить в полиз
   */
-  void PolizPush(PolizLit lit) { poliz_.push_back(new PolizLit(lit)); }
+  void PolizPush(const VarData& data) {
+    poliz_.Emit(OpCodes::Const, poliz_.AddConst(data));
+  }
   /*!
    * @brief Добавить в ПОЛИЗ операцию вызова функции
    * @param args Кол-во аргументов функции
-   * @param func Имя вызываемой функции
+   * @param func Номер вызываемой функции в funcs_
   */
-  void PolizPush(int args, std::string func) {
-    poliz_.push_back(new PolizFuncCall(args, func));
+  void PolizPush(int args, uint32_t func) {
+    poliz_.Emit(OpCodes::Call, args, func);
   }
   /*!
-   * @brief Добавить в полиз пустой элемент
-   * @return Индек пропущенного элемента
+   * @brief Добавить в ПОЛИЗ переход по известному адресу
+   * @param jump Операция перехода
+   * @param address Адрес перехода
+  */
+  void PolizJump(OpCodes jump, int address) { poliz_.Emit(jump, address); }
+  /*!
+   * @brief Добавить в полиз переход, адрес которого станет известен позже
+   * @param jump Операция перехода
+   * @return Смещение адреса перехода в коде
   */
-  int PolizSkip() { 
-    poliz_.push_back(nullptr);
-    return poliz_.size() - 1;
+  int PolizSkip(OpCodes jump) {
+    poliz_.Emit(jump, 0);
+    return poliz_.size() - sizeof(uint32_t);
   }
+  /*!
+   * @brief Дописать адрес перехода, пропущенный PolizSkip
+   * @param ind Смещение адреса перехода
+   * @param address Адрес перехода
+  */
+  void PolizFill(int ind, int address) { poliz_.Patch(ind, address); }
 
   /*!
-   * @brief Переход к следующей лексеме
+   * @brief Проверяет, что текущая лексема - последняя во входных данных
+   * @return true, если дальше лексем нет
+   * На последней лексеме PushLexeme больше не сдвигается, так что циклы
+   * разбора списков должны останавливаться здесь
    */
+  bool AtEnd() const {
+    return static_cast<size_t>(cur_ind_) + 1 >= lexemes_.size();
+  }
   void PushLexeme() { 
-    if (cur_ind_ != lexemes_.size() - 1) cur_ = lexemes_[++cur_ind_];
+    if (!AtEnd()) cur_ = lexemes_[++cur_ind_];
   }
   /*!
    * @brief Проверяет, равна ли текущая лексема необходимой строке
@@ -232,64 +283,38 @@ class Compiler {
    */
   void CheckLexeme(std::string val) {
     if (cur_ != val.data()) {
-      throw std::invalid_argument("error in lexeme " + cur_.text() +
-                                  " in line " + std::to_string(cur_.line()));
+      throw std::invalid_argument("error in lexeme " +
+                                  std::string(cur_.text()) + " in line " +
+                                  std::to_string(cur_.line()));
     }
   }
   /*!
    * @brief Проверяет, есть ли функция или структура с именем name
-   * @param name Имя, которое нужно найти среди функций и структур
+   * @param name Символ имени, которое нужно найти среди функций и структур
    * @return true или false если найдено и нет соответственно
    */
-  bool FindFuncStruct(std::string name) {
-    bool func = false, struc = false;
-    for (auto val : structs_) {
-      if (val.name() == name) {
-        struc = true;
-      }
-    }
-
-    for (auto val : funcs_) {
-      if (val.name() == name) {
-        func = true;
-      }
-    }
-    return func || struc;
-  }
+  bool FindFuncStruct(int name) { return FindFunc(name) || FindStruc(name); }
   /*!
    * @brief Проверяет, есть ли функция с именем name
-   * @param name Имя, которое нужно найти среди функций
+   * @param name Символ имени, которое нужно найти среди функций
    * @return true или false если найдена и нет соответственно
    */
-  bool FindFunc(std::string name) {
-    for (auto val : funcs_) {
-      if (val.name() == name) {
-        return true;
-      }
-    }
-    return false;
-  }
+  bool FindFunc(int name) { return funcs_.Find(name) != nullptr; }
   /*!
    * @brief Проверяет, есть ли структура с именем name
-   * @param name Имя, которое нужно найти среди структур
+   * @param name Символ имени, которое нужно найти среди структур
    * @return true или false если найдена и нет соответственно
    */
-  bool FindStruc(std::string name) {
-    for (auto val : structs_) {
-      if (val.name() == name) {
-        return true;
-      }
-    }
-    return false;
-  }
+  bool FindStruc(int name) { return structs_.Find(name) != nullptr; }
 
   void Struct() {
     CheckLexeme("struct");
     PushLexeme();
     Identifier();
-    std::string type = lexemes_[cur_ind_ - 1].text();
-    StructInfo new_struct(type);
-    if (tid_.CheckID(type) || FindFuncStruct(type)) {
+    std::string type(lexemes_[cur_ind_ - 1].text());
+    int symbol = lexemes_[cur_ind_ - 1].symbol();
+    StructInfo new_struct(type, symbol);
+    if (tid_.CheckID(symbol) || FindFuncStruct(symbol)) {
       throw std::invalid_argument("Typename " + type + " is busy");
     }
     CheckLexeme("{");
@@ -302,7 +327,7 @@ class Compiler {
       VarDefinition();
     }
 
-    for (auto val : tid_.cur()->rows()) {
+    for (auto& val : tid_.ScopeRows()) {
       new_struct.AddVariable(val.type(), val.name());
     }
 
@@ -310,12 +335,12 @@ class Compiler {
       new_struct.AddMethod(Func());
     }
 
-    structs_.push_back(new_struct);
+    structs_.Add(new_struct);
     CheckLexeme("}");
     PushLexeme();
     tid_.Back();
     if (cur_ != ";") {
-      ObjectNames(type);
+      ObjectNames(TypeDesc(BaseTypes::Struct, ValueKinds::Value, symbol));
     }
     CheckLexeme(";");
     PushLexeme();
@@ -326,27 +351,31 @@ class Compiler {
    */
   FunctionInfo Func() {
     Type();
-    std::string type = lexemes_[cur_ind_ - 1].text();
-    cur_func.set_type(type);
+    std::string type(lexemes_[cur_ind_ - 1].text());
+    int type_symbol = lexemes_[cur_ind_ - 1].symbol();
+    TypeDesc type_desc = ToTypeDesc(type, type_symbol);
+    cur_func.set_type(type_desc);
     Identifier();
-    std::string id = lexemes_[cur_ind_ - 1].text();
-    if (tid_.CheckID(type) || FindFuncStruct(type)) {
+    std::string id(lexemes_[cur_ind_ - 1].text());
+    int symbol = lexemes_[cur_ind_ - 1].symbol();
+    if (tid_.CheckID(type_symbol) || FindFuncStruct(type_symbol)) {
       throw std::invalid_argument("Object with the name of the function " +
                                   type + " already exists");
     }
     CheckLexeme("(");
     PushLexeme();
     tid_.NewScope();
+    tid_.BeginFrame();
 
-    std::vector<std::pair<std::string, std::string>> args;
+    std::vector<std::pair<TypeDesc, int>> args;
     if (cur_ != ")") {
       do {
         if (cur_ == ",") {
           PushLexeme();
         }
         Parameter();
-        args.emplace_back(lexemes_[cur_ind_ - 2].text(),
-                          lexemes_[cur_ind_ - 1].text());
+        args.emplace_back(tid_.GetID(lexemes_[cur_ind_ - 1].symbol()).type(),
+                          lexemes_[cur_ind_ - 1].symbol());
       } while (cur_ == ",");
       CheckLexeme(")");
       PushLexeme();
@@ -354,14 +383,11 @@ class Compiler {
       PushLexeme();
     }
 
-    cur_func = FunctionInfo(type, id, args);
+    cur_func = FunctionInfo(type_desc, id, symbol, args);
     cur_func.set_poliz_start(poliz_.size());
-    for (auto val : args) {
-      cur_func.AddArgument(tid_.GetID(val.second).var());
-    }
-
 
     Block(true);
+    cur_func.set_frame(tid_.EndFrame());
     return cur_func;
   }
   void VarDefinition() {
@@ -371,7 +397,8 @@ class Compiler {
           "Variable type can't be void in line " +
           std::to_string(lexemes_[cur_ind_ - 1].line()));
     }
-    ObjectNames(lexemes_[cur_ind_ - 1].text());
+    ObjectNames(ToTypeDesc(lexemes_[cur_ind_ - 1].text(),
+                           lexemes_[cur_ind_ - 1].symbol()));
     CheckLexeme(";");
     PushLexeme();
   }
@@ -396,240 +423,154 @@ class Compiler {
   }
   void Identifier() {
     if (cur_.type() != LexemeTypes::Id) {
-      throw std::invalid_argument("error in lexeme " + cur_.text() +
-                                  " in line " + std::to_string(cur_.line()));
+      throw std::invalid_argument("error in lexeme " +
+                                  std::string(cur_.text()) + " in line " +
+                                  std::to_string(cur_.line()));
     }
     PushLexeme();
   }
   void Definitions() {
-    if (lexemes_[cur_ind_ + 2] == "(") {
-      Func();
-    } else {
-      VarDefinition();
-    }
-    if (cur_ != "}") {
-      Definitions();
-    }
+    do {
+      if (lexemes_[cur_ind_ + 2] == "(") {
+        Func();
+      } else {
+        VarDefinition();
+      }
+    } while (cur_ != "}" && !AtEnd());
   }
   /*!
    * @brief Анализ имен объектов
    * @param type Какому типа принадлежат имена объектов
    */
-  void ObjectNames(std::string type) {
+  void ObjectNames(TypeDesc type) {
+    ObjectName(type);
+    while (cur_ == ",") {
+      PushLexeme();
+      ObjectName(type);
+    }
+  }
+  /*!
+   * @brief Анализ одного имени объекта из списка ObjectNames
+   * @param type Какому типа принадлежит имя объекта
+   */
+  void ObjectName(TypeDesc type) {
     int size = 0;
     // без объявления функции
     Identifier();
-    std::string id = lexemes_[cur_ind_ - 1].text();
-    if (tid_.cur()->FindVar(id) || FindFuncStruct(id)) {
-      throw std::invalid_argument("Variable name " + id + " is busy in line " +
+    int id = lexemes_[cur_ind_ - 1].symbol();
+    if (tid_.FindVar(id) || FindFuncStruct(id)) {
+      throw std::invalid_argument("Variable name " +
+                                  std::string(lexemes_[cur_ind_ - 1].text()) +
+                                  " is busy in line " +
                                   std::to_string(cur_.line()));
     }
 
-    std::string list;
     if (cur_ == "[") {
       PushLexeme();
       IntLit();
-      if (std::stoi(lexemes_[cur_ind_ - 1].text()) < 1) {
+      if (std::stoi(std::string(lexemes_[cur_ind_ - 1].text())) < 1) {
         throw std::invalid_argument("Array size must be pozitive in line " +
                                     std::to_string(cur_.line()));
       }
-      size = std::stoi(lexemes_[cur_ind_ - 1].text());
+      size = std::stoi(std::string(lexemes_[cur_ind_ - 1].text()));
       CheckLexeme("]");
-      list = "l";
       PushLexeme();
-      tid_.Push(id, list + type, size);
-      cur_func.AddLocalVar(tid_.GetID(id).var());
+      tid_.Push(id, type.As(ValueKinds::List), size);
     } else if (cur_ == "=") {
-      tid_.Push(id, list + type, size);
-      cur_func.AddLocalVar(tid_.GetID(id).var());
+      tid_.Push(id, type, size);
 
-      PolizPush(tid_.GetID(id).var());
+      PolizPush(tid_.GetID(id));
       PushLexeme();
       Expression();
-      PolizPush("=");
+      PolizPush(OpCodes::Assign, type, stack_.Top());
     } else {
-      tid_.Push(id, list + type, size);
-      cur_func.AddLocalVar(tid_.GetID(id).var());
-    }
-    if (cur_ == ",") {
-      PushLexeme();
-      ObjectNames(type);
+      tid_.Push(id, type, size);
     }
   }
   void Type() {
-    bool found_struct = false;
-    for (auto val : structs_) {
-      if (val.name() == cur_.text()) {
-        found_struct = true;
-      }
-    }
     if (cur_ != "int" && cur_ != "float" && cur_ != "void" && cur_ != "bool" &&
-        cur_ != "string" && !found_struct) {
-      throw std::invalid_argument("error in lexeme " + cur_.text() +
-                                  " in line " + std::to_string(cur_.line()));
+        cur_ != "string" && !FindStruc(cur_.symbol())) {
+      throw std::invalid_argument("error in lexeme " +
+                                  std::string(cur_.text()) + " in line " +
+                                  std::to_string(cur_.line()));
     }
     PushLexeme();
   }
   void Parameter() {
     Type();
     Identifier();
-    if (tid_.CheckID(lexemes_[cur_ind_ - 1].text()) ||
-        FindFuncStruct(lexemes_[cur_ind_ - 1].text())) {
+    int id = lexemes_[cur_ind_ - 1].symbol();
+    if (tid_.CheckID(id) || FindFuncStruct(id)) {
       throw std::invalid_argument("Function argument name " +
-                                  lexemes_[cur_ind_ - 1].text() + " is busy");
+                                  std::string(lexemes_[cur_ind_ - 1].text()) +
+                                              " is busy");
     }
-    tid_.Push(lexemes_[cur_ind_ - 1].text(), lexemes_[cur_ind_ - 2].text());
+    tid_.Push(id, ToTypeDesc(lexemes_[cur_ind_ - 2].text(),
+                             lexemes_[cur_ind_ - 2].symbol()));
   }
   void Operators() {
-    Operator();
-    if (cur_ != "}") {
-      Operators();
-    }
+    do {
+      Operator();
+    } while (cur_ != "}" && !AtEnd());
   }
   void IntLit() {
     if (cur_.type() != LexemeTypes::NumLit ||
         cur_.text().find('.') != std::string::npos) {
-      throw std::invalid_argument("error in lexeme " + cur_.text() +
-                                  " in line " + std::to_string(cur_.line()));
+      throw std::invalid_argument("error in lexeme " +
+                                  std::string(cur_.text()) + " in line " +
+                                  std::to_string(cur_.line()));
     }
     PushLexeme();
   }
-  void Expression() {
-    ExpressionNoComma();
-    while (cur_.type() == LexemeTypes::Priority10) {
-      stack_.Push(cur_.text());
-      auto tmp = cur_.text();
-      PushLexeme();
-      Expression();
-
-      PolizPush(tmp);
-
-      stack_.CheckBin();
-    }
-  }
-  void ExpressionNoComma() {
-    Chain8();
-    while (cur_.type() == LexemeTypes::Priority9) {
-      stack_.Push(cur_.text());
-      auto tmp = cur_.text();
-
-      PushLexeme();
-      ExpressionNoComma();
-
-      PolizPush(tmp);
-
-      stack_.CheckBin();
-    }
-  }
-  void Chain8() {
-    Chain7();
-    while (cur_.type() == LexemeTypes::Priority8) {
-      stack_.Push(cur_.text());
-      auto tmp = cur_.text();
-
-      PushLexeme();
-      Chain8();
-
-      PolizPush(tmp);
-
-      stack_.CheckBin();
-    }
-  }
-  void Chain7() {
-    Chain6();
-    while (cur_.type() == LexemeTypes::Priority7) {
-      stack_.Push(cur_.text());
-
-      auto tmp = cur_.text();
-
-      PushLexeme();
-      Chain7();
-
-      PolizPush(tmp);
-
-      stack_.CheckBin();
-    }
-  }
-  void Chain6() {
-    Chain5();
-    while (cur_.type() == LexemeTypes::Priority6) {
-      stack_.Push(cur_.text());
-
-      auto tmp = cur_.text();
-
-      PushLexeme();
-      Chain6();
-
-      PolizPush(tmp);
-
-      stack_.CheckBin();
-    }
-  }
-  void Chain5() {
-    Chain4();
-    while (cur_.type() == LexemeTypes::Priority5) {
-      stack_.Push(cur_.text());
-
-      auto tmp = cur_.text();
-
-      PushLexeme();
-      Chain5();
-
-      PolizPush(tmp);
-
-      stack_.CheckBin();
-    }
-  }
-  void Chain4() {
-    Chain3();
-    while (cur_.type() == LexemeTypes::Priority4) {
-      stack_.Push(cur_.text());
-
-      auto tmp = cur_.text();
-
-      PushLexeme();
-      Chain4();
-
-      PolizPush(tmp);
-
-      stack_.CheckBin();
-    }
-  }
-  void Chain3() {
-    Chain2();
-    while (cur_.type() == LexemeTypes::Priority3) {
-      stack_.Push(cur_.text());
-
-      auto tmp = cur_.text();
+  void Expression() { Binary(LexemeTypes::Priority10); }
+  void ExpressionNoComma() { Binary(LexemeTypes::Priority9); }
+  /*!
+   * @brief Анализ бинарных операций методом восхождения по приоритетам
+   * @param weakest Самый слабый приоритет операций, которые входят в выражение
+   * Все бинарные операции правоассоциативны: правый операнд разбирается с
+   * приоритетом самой операции, так что ПОЛИЗ тот же, что и при разборе
+   * отдельной функцией на каждый уровень приоритета
+   */
+  void Binary(LexemeTypes weakest) {
+    Chain1();
+    while (cur_.type() >= LexemeTypes::Priority2 && cur_.type() <= weakest) {
+      LexemeTypes priority = cur_.type();
+      TypeDesc lhs = stack_.Top();
+      stack_.PushOper(cur_.text());
+      std::string tmp(cur_.text());
 
       PushLexeme();
-      Chain3();
-
-      PolizPush(tmp);
+      if (short_circuit_ && (tmp == "&&" || tmp == "||")) {
+        ShortCircuit(tmp == "&&" ? OpCodes::AndJump : OpCodes::OrJump,
+                     priority);
+      } else {
+        Binary(priority);
+        PolizPush(ToOpCode(tmp), lhs, stack_.Top());
+      }
 
       stack_.CheckBin();
     }
   }
-  void Chain2() {
-    Chain1();
-    while (cur_.type() == LexemeTypes::Priority2) {
-      stack_.Push(cur_.text());
-
-      auto tmp = cur_.text();
-
-      PushLexeme();
-      Chain2();
-
-      PolizPush(tmp);
-
-      stack_.CheckBin();
+  /*!
+   * @brief Анализ правого операнда && или || с вычислением по короткой схеме
+   *
+   * Если результат известен по левому операнду, переход оставляет его в стеке и обходит код правого операнда. Иначе результат - правый операнд, приведенный к bool, как у VarData::operator&&
+   * @param jump Переход AndJump для && или OrJump для ||
+   * @param priority Приоритет операции
+  */
+  void ShortCircuit(OpCodes jump, LexemeTypes priority) {
+    int skip = PolizSkip(jump);
+    Binary(priority);
+    TypeDesc rhs = stack_.Top();
+    if (rhs.base != BaseTypes::Bool || rhs.kind != ValueKinds::Value) {
+      poliz_.Emit(OpCodes::Cast, Bool);
     }
+    PolizFill(skip, poliz_.size());
   }
   void Chain1() {
-    std::stack<std::string> opers;
     std::string tmp;
     if (cur_ == "--" || cur_ == "++" || cur_ == "!") {
-      stack_.Push(cur_.text());
+      stack_.PushOper(cur_.text());
       tmp = cur_.text();
       PushLexeme();
       Chain1();
@@ -645,7 +586,7 @@ class Compiler {
     std::string tmp;
     if (cur_ == "+" || cur_ == "-") {
       PushLexeme();
-      tmp = "un" + cur_.text();
+      tmp = "un" + std::string(cur_.text());
     }
     ExpressionStop();
     while (cur_ == "[" || cur_ == "." ||
@@ -659,49 +600,49 @@ class Compiler {
   }
   void Priority0() {
     if (cur_ == "[") {
-      stack_.Push("[]");
+      stack_.PushOper("[]");
       PushLexeme();
       Expression();
       CheckLexeme("]");
       stack_.CheckBin();
-      PolizPush("[]");
+      PolizPush(OpCodes::Index);
       PushLexeme();
     } else if (cur_ == ".") {
       // to do
       PushLexeme();
       Identifier();
-      std::string name = lexemes_[cur_ind_ - 1].text();
-      StructInfo struc;
-      for (auto val : structs_) {
-        auto tmp = stack_.Top();
-        if (tmp[0] == 'a') tmp.erase(tmp.begin());
-        if (tmp == val.name()) {
-          struc = val;
-        }
-      }
+      std::string name(lexemes_[cur_ind_ - 1].text());
+      int symbol = lexemes_[cur_ind_ - 1].symbol();
+      TypeDesc tmp = stack_.Top();
+      const StructInfo* found =
+          tmp.base == BaseTypes::Struct ? structs_.Find(tmp.symbol) : nullptr;
+      static const StructInfo kNoStruct;
+      const StructInfo& struc = found ? *found : kNoStruct;
       if (cur_.text() == "(") {
-        if (struc.FindMethod(name).name().empty()) {
+        const FunctionInfo* method = struc.FindMethod(symbol);
+        if (!method) {
           throw std::invalid_argument("No member " + name + " in struct " +
                                       struc.name());
         }
-        cur_ = lexemes_[--cur_ind_];
-        FuncCall(struc.FindMethod(name));
-        stack_.Pop();
-        stack_.Push(struc.FindMethod(name).type());
+        // методы структур не попадают в funcs_, поэтому вызвать их нечем
+        throw std::invalid_argument("Struct method " + name +
+                                    " can't be called");
       } else {
-        if (struc.FindVariable(name).empty()) {
+        const TypeDesc* type = struc.FindVariable(symbol);
+        if (!type) {
           throw std::invalid_argument("No member " + name + " in struct " +
                                       struc.name());
         }
         stack_.Pop();
-        stack_.Push("a" + struc.FindVariable(name));
+        stack_.Push(type->As(ValueKinds::Lvalue));
       }
     } else if (cur_.type() == LexemeTypes::Priority0) {
       PushLexeme();
-      PolizPush("post" + cur_.text());
+      PolizPush("post" + std::string(cur_.text()));
     } else {
-      throw std::invalid_argument("error in lexeme " + cur_.text() +
-                                  " in line " + std::to_string(cur_.line()));
+      throw std::invalid_argument("error in lexeme " +
+                                  std::string(cur_.text()) + " in line " +
+                                  std::to_string(cur_.line()));
     }
   }
   void ExpressionStop() {
@@ -714,68 +655,57 @@ class Compiler {
                LexemeTypes::StringLit == cur_.type() ||
                cur_.type() == LexemeTypes::BoolLit) {
       if (cur_.type() == LexemeTypes::BoolLit) {
-        stack_.Push("bool");
-        PolizLit lit(Bool);
-        lit.data_.bool_ = cur_.text() == "true";
-        PolizPush(lit);
+        stack_.Push(TypeDesc(BaseTypes::Bool));
+        PolizPush(VarData(cur_.text() == "true"));
       } else if (cur_.type() == LexemeTypes::NumLit) {
         if (cur_.text().find('.') != std::string::npos) {
-          stack_.Push("float");
-          PolizLit lit(Float);
-          lit.data_.float_ = std::stof(cur_.text());
-          PolizPush(lit);
+          stack_.Push(TypeDesc(BaseTypes::Float));
+          PolizPush(VarData(std::stof(std::string(cur_.text()))));
         } else {
-          stack_.Push("int");
-          PolizLit lit(Int);
-          lit.data_.int_ = std::stoi(cur_.text());
-          PolizPush(lit);
+          stack_.Push(TypeDesc(BaseTypes::Int));
+          PolizPush(VarData(std::stoi(std::string(cur_.text()))));
         }
       } else if (LexemeTypes::StringLit == cur_.type()) {
-        stack_.Push("string");
-        PolizLit lit(String);
-        lit.data_.string_ = cur_.text();
-        PolizPush(lit);
+        stack_.Push(TypeDesc(BaseTypes::String));
+        PolizPush(VarData::Constant(poliz_.strings(), cur_.text()));
       }
       PushLexeme();
     } else if (cur_.type() == LexemeTypes::Id) {
-      if (tid_.CheckID(cur_.text())) {
-        auto tmp = tid_.GetID(cur_.text()).type();
-        if (tmp[0] != 'l')
-          stack_.Push("a" + tid_.GetID(cur_.text()).type());
+      if (tid_.CheckID(cur_.symbol())) {
+        auto& row = tid_.GetID(cur_.symbol());
+        if (row.type().kind != ValueKinds::List)
+          stack_.Push(row.type().As(ValueKinds::Lvalue));
         else
-          stack_.Push(tid_.GetID(cur_.text()).type());
+          stack_.Push(row.type());
 
-        PolizPush(tid_.GetID(cur_.text()).var());
+        PolizPush(row);
 
         PushLexeme();
-      } else if (FindFunc(cur_.text()) || cur_func.name()==cur_.text()) {
-        FunctionInfo func;
-        for (auto val : funcs_) {
-          if (val.name() == cur_.text()) {
-            func = val;
-          }
-        }
-
-        if (cur_func.name() == cur_.text()) {
-          func = cur_func;
-        }
-
-        FuncCall(func);
+      } else if (FindFunc(cur_.symbol()) ||
+                 cur_func.symbol() == cur_.symbol()) {
+        // разбираемая функция попадет в funcs_ следующей, когда ее разбор закончится
+        bool self = cur_func.symbol() == cur_.symbol();
+        const FunctionInfo& func = self ? cur_func : *funcs_.Find(cur_.symbol());
+        FuncCall(func, self ? funcs_.items().size()
+                            : funcs_.IndexOf(cur_.symbol()));
         stack_.Push(func.type());
       } else {
-        throw std::invalid_argument("No member named: " + cur_.text() +
-                                    " in line " + std::to_string(cur_.line()));
+        throw std::invalid_argument("No member named: " +
+                                    std::string(cur_.text()) + " in line " +
+                                    std::to_string(cur_.line()));
       }
     } else {
-      throw std::invalid_argument("error in lexeme " + cur_.text() +
-                                  " in line " + std::to_string(cur_.line()));
+      throw std::invalid_argument("error in lexeme " +
+                                  std::string(cur_.text()) + " in line " +
+                                  std::to_string(cur_.line()));
     }
   }
   /*!
    * @brief Анализ вызова функции
    * @param func Информация о функции, которая вызывается
+   * @param index Номер функции в funcs_, который попадет в операцию вызова
   */
-  void FuncCall(FunctionInfo func) {
+  void FuncCall(const FunctionInfo& func, uint32_t index) {
     PushLexeme();
     CheckLexeme("(");
     PushLexeme();
@@ -792,7 +722,8 @@ class Compiler {
       if (i >= func.args().size() ||
           !CompareTypes(stack_.Top(), func.args()[i++].first)) {
         throw std::invalid_argument(
-            stack_.Top() + " can't be converted to " + func.args()[i++].first +
+            stack_.Name(stack_.Top()) + " can't be converted to " +
+            stack_.Name(func.args()[i++].first) +
             " in function call or there are too much arguments in line " +
             std::to_string(cur_.line()));
       }
@@ -811,7 +742,7 @@ class Compiler {
     }
 
     CheckLexeme(")");
-    PolizPush(func.args().size(), func.name());
+    PolizPush(func.args().size(), index);
     PushLexeme();
   }
   void Operator() {
@@ -829,19 +760,27 @@ class Compiler {
       if (cur_ != ";") {
         Expression();
 
-        PolizPush("return");
+        // значение приводится к типу функции, чтобы тип результата вызова
+        // был известен при трансляции
+        TypeDesc value = stack_.Top();
+        if (IsStandardType(value.base) && IsStandardType(cur_func.type().base) &&
+            ToVarType(value) != ToVarType(cur_func.type())) {
+          poliz_.Emit(OpCodes::Cast, ToVarType(cur_func.type()));
+        }
+        PolizPush(OpCodes::Return);
 
         if (!CompareTypes(stack_.Top(), cur_func.type())) {
           throw std::invalid_argument(
-              "Function return type " + cur_func.type() +
-              " doesn't match with the return value type " + stack_.Top() +
+              "Function return type " + stack_.Name(cur_func.type()) +
+              " doesn't match with the return value type " +
+              stack_.Name(stack_.Top()) +
               " in line " + std::to_string(cur_.line()));
         }
         CheckLexeme(";");
         PushLexeme();
         stack_.Pop();
       } else {
-        if (cur_func.type() != "void") {
+        if (cur_func.type().base != BaseTypes::Void) {
           throw std::invalid_argument("Function must return value in line " +
                                       std::to_string(cur_.line()));
         }
@@ -861,8 +800,7 @@ class Compiler {
                                     std::to_string(cur_.line()));
       }
 
-      loops_breaks_to_fill_.top().push_back(PolizSkip());
-      PolizPush("B!");
+      loops_breaks_to_fill_.top().push_back(PolizSkip(OpCodes::Jump));
 
     } else if (cur_ == "continue") {
       PushLexeme();
@@ -874,13 +812,12 @@ class Compiler {
                                     std::to_string(cur_.line()));
       }
 
-      PolizPush(loops_starts_.top());
-      PolizPush("B!");
+      PolizJump(OpCodes::Jump, loops_starts_.top());
 
     } else if (cur_ == "{") {
       Block();
     } else if ((cur_.type() == LexemeTypes::Keyword ||
-                FindStruc(cur_.text())) &&
+                FindStruc(cur_.symbol())) &&
                lexemes_[cur_ind_ + 1].type() == LexemeTypes::Id) {
       VarDefinition();
     } else if (cur_ == ";") {
@@ -889,7 +826,7 @@ class Compiler {
       Expression();
       CheckLexeme(";");
 
-      PolizPush(";");
+      PolizPush(OpCodes::Pop);
 
       PushLexeme();
       stack_.Pop();
@@ -902,25 +839,23 @@ class Compiler {
     PushLexeme();
     Expression();
 
-    int tmp1 = PolizSkip();
-    PolizPush("F!");
+    int tmp1 = PolizSkip(OpCodes::JumpFalse);
 
     stack_.CheckBool();
     CheckLexeme(")");
     PushLexeme();
     Operator();
 
-    int tmp2 = PolizSkip();
-    PolizPush("B!");
+    int tmp2 = PolizSkip(OpCodes::Jump);
 
-    poliz_[tmp1] = new PolizAddress(poliz_.size());
+    PolizFill(tmp1, poliz_.size());
     if (cur_ == "else") {
       PushLexeme();
       Operator();
     }
 
 
-    poliz_[tmp2] = new PolizAddress(poliz_.size());
+    PolizFill(tmp2, poliz_.size());
   }
   void While() {
     CheckLexeme("while");
@@ -933,8 +868,7 @@ class Compiler {
 
     Expression();
 
-    int tmp1 = PolizSkip();
-    PolizPush("F!");
+    int tmp1 = PolizSkip(OpCodes::JumpFalse);
 
     stack_.CheckBool();
     CheckLexeme(")");
@@ -945,15 +879,14 @@ class Compiler {
     Operator();
 
 
-    PolizPush(tmp2);
-    PolizPush("B!");
+    PolizJump(OpCodes::Jump, tmp2);
     
-    poliz_[tmp1] = new PolizAddress(poliz_.size());
+    PolizFill(tmp1, poliz_.size());
 
     loops_starts_.pop();
 
     for (auto val : loops_breaks_to_fill_.top()) {
-      poliz_[val] = new PolizAddress(poliz_.size());
+      PolizFill(val, poliz_.size());
     }
     loops_breaks_to_fill_.pop();
   }
@@ -978,11 +911,9 @@ class Compiler {
     CheckLexeme(";");
     PushLexeme();
 
-    int tmp2 = PolizSkip();
-    PolizPush("F!");
+    int tmp2 = PolizSkip(OpCodes::JumpFalse);
 
-    int tmp4 = PolizSkip();
-    PolizPush("B!");
+    int tmp4 = PolizSkip(OpCodes::Jump);
 
     int tmp3 = poliz_.size();
     loops_starts_.push(tmp3);
@@ -991,26 +922,24 @@ class Compiler {
       stack_.Pop();
     }
 
-    PolizPush(tmp1);
-    PolizPush("B!");
+    PolizJump(OpCodes::Jump, tmp1);
 
     CheckLexeme(")");
     PushLexeme();
 
-    poliz_[tmp4] = new PolizAddress(poliz_.size());
+    PolizFill(tmp4, poliz_.size());
 
     loops_breaks_to_fill_.push(std::vector<int>());
 
     Operator();
 
-    PolizPush(tmp3);
-    PolizPush("B!");
+    PolizJump(OpCodes::Jump, tmp3);
 
-    poliz_[tmp2] = new PolizAddress(poliz_.size());
+    PolizFill(tmp2, poliz_.size());
 
     loops_starts_.pop();
     for (auto val : loops_breaks_to_fill_.top()) {
-      poliz_[val] = new PolizAddress(poliz_.size());
+      PolizFill(val, poliz_.size());
     }
     loops_breaks_to_fill_.pop();
   }
@@ -1030,11 +959,9 @@ class Compiler {
 
     Expression();
 
-    int tmp2 = PolizSkip();
-    PolizPush("F!");
+    int tmp2 = PolizSkip(OpCodes::JumpFalse);
 
-    PolizPush(tmp1);
-    PolizPush("B!");
+    PolizJump(OpCodes::Jump, tmp1);
 
     stack_.CheckBool();
     CheckLexeme(")");
@@ -1042,7 +969,7 @@ class Compiler {
     CheckLexeme(";");
     PushLexeme();
 
-    poliz_[tmp2] = new PolizAddress(poliz_.size());
+    PolizFill(tmp2, poliz_.size());
   }
   void In() {
     CheckLexeme("in");
@@ -1059,8 +986,8 @@ class Compiler {
         CheckLexeme(",");
         PushLexeme();
         if (cur_ == ")") {
-          throw std::invalid_argument("error in lexeme " + cur_.text() +
-                                      " in line " +
+          throw std::invalid_argument("error in lexeme " +
+                                      std::string(cur_.text()) + " in line " +
                                       std::to_string(cur_.line()));
         }
       }
@@ -1071,10 +998,8 @@ class Compiler {
     CheckLexeme(";");
     PushLexeme();
 
-    PolizLit lit(Int);
-    lit.data_.int_ = n;
-    PolizPush(lit);
-    PolizPush("in");
+    PolizPush(VarData(n));
+    PolizPush(OpCodes::In);
 
   }
   void Out() {
@@ -1092,8 +1017,8 @@ class Compiler {
         CheckLexeme(",");
         PushLexeme();
         if (cur_ == ")") {
-          throw std::invalid_argument("error in lexeme " + cur_.text() +
-                                      " in line " +
+          throw std::invalid_argument("error in lexeme " +
+                                      std::string(cur_.text()) + " in line " +
                                       std::to_string(cur_.line()));
         }
       }
@@ -1105,31 +1030,138 @@ class Compiler {
     CheckLexeme(";");
     PushLexeme();
 
-    PolizLit lit(Int);
-    lit.data_.int_ = n;
-    PolizPush(lit);
-    PolizPush("out");
+    PolizPush(VarData(n));
+    PolizPush(OpCodes::Out);
   }
   void Expressions() {
     ExpressionNoComma();
-    if (cur_ == ",") {
-      stack_.Push(cur_.text());
+    int commas = 0;
+    while (cur_ == ",") {
+      stack_.PushOper(cur_.text());
       PushLexeme();
-      Expressions();
-
+      ExpressionNoComma();
+      ++commas;
+    }
+    // запятые выводятся в ПОЛИЗ после всех выражений, как при правой
+    // ассоциативности
+    for (int i = 0; i < commas; ++i) {
       stack_.CheckBool();
 
-      PolizPush(",");
+      PolizPush(OpCodes::Comma);
     }
   }
 };
 
-int main() {
-  Separator sep;
-  sep.unload("text.txt");
-  Compiler analyzer("separated.txt", "operations.txt");
+int main(int argc, char* argv[]) {
+  if (argc > 2 && std::string(argv[1]) == "-bench-lexer") {
+    unsigned threads = argc > 4 ? std::stoi(argv[4])
+                                : std::thread::hardware_concurrency();
+    BenchmarkLexer(argv[2], argc > 3 ? std::stoi(argv[3]) : 100,
+                   std::max(1u, threads));
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "-check-lexer") {
+    return CheckLexer<Compiler>() ? 0 : 1;
+  }
+  if (argc > 1 && std::string(argv[1]) == "-bench-scopes") {
+    int globals = argc > 2 ? std::stoi(argv[2]) : 5000;
+    int depth = argc > 3 ? std::stoi(argv[3]) : 100;
+    BenchmarkCompile<Compiler>(
+        "scopes, " + std::to_string(globals) + " globals, depth " +
+            std::to_string(depth),
+        ScopesProgram(globals, depth), argc > 4 ? std::stoi(argv[4]) : 5);
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "-bench-funcs") {
+    int funcs = argc > 2 ? std::stoi(argv[2]) : 5000;
+    BenchmarkCompile<Compiler>(
+        "funcs, " + std::to_string(funcs) + " functions",
+        FunctionsProgram(funcs), argc > 3 ? std::stoi(argv[3]) : 5);
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "-bench-exprs") {
+    int lines = argc > 2 ? std::stoi(argv[2]) : 100000;
+    BenchmarkCompile<Compiler>(
+        "exprs, " + std::to_string(lines) + " expressions",
+        ExpressionsProgram(lines), argc > 3 ? std::stoi(argv[3]) : 5);
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "-bench-dispatch") {
+    BenchmarkDispatch<Compiler>(argc > 2 ? std::stoi(argv[2]) : 200000,
+                                argc > 3 ? std::stoi(argv[3]) : 5);
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "-bench-typed") {
+    BenchmarkTyped<Compiler>(argc > 2 ? std::stoi(argv[2]) : 200000,
+                             argc > 3 ? std::stoi(argv[3]) : 5);
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "-bench-logic") {
+    BenchmarkShortCircuit<Compiler>(argc > 2 ? std::stoi(argv[2]) : 200000,
+                                    argc > 3 ? std::stoi(argv[3]) : 5);
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "-stress") {
+    return StressCompile<Compiler>(argc > 2 ? std::stoi(argv[2]) : 1000000)
+               ? 0
+               : 1;
+  }
+  if (argc > 1 && std::string(argv[1]) == "-stress-loop") {
+    return StressLoop<Compiler>(argc > 2 ? std::stoi(argv[2]) : 100000000,
+                                argc > 3 ? std::stoi(argv[3]) : 1000000,
+                                argc > 4 ? std::stoi(argv[4]) : 200)
+               ? 0
+               : 1;
+  }
+  if (argc > 1 && std::string(argv[1]) == "-optimize") {
+    try {
+      Separator sep;
+      sep.unload(argc > 2 ? argv[2] : "text.txt");
+      Compiler analyzer(std::move(sep.lexemes()));
+      analyzer.Program();
+      OptimizeStats stats = analyzer.Optimize();
+      std::cout << "instructions: " << stats.instructions << " -> "
+                << stats.instructions - stats.eliminated << ", eliminated "
+                << stats.eliminated << ", constant reads "
+                << stats.propagated << '\n';
+    } catch (std::invalid_argument& err) {
+      std::cout << err.what();
+    }
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "-compile") {
+    try {
+      Separator sep;
+      sep.unload(argc > 2 ? argv[2] : "text.txt");
+      Compiler analyzer(std::move(sep.lexemes()));
+      analyzer.Program();
+      analyzer.Optimize();
+      analyzer.WriteProgram(argc > 3 ? argv[3] : "program.dcp");
+    } catch (std::invalid_argument& err) {
+      std::cout << err.what();
+    }
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "-run") {
+    try {
+      ProgramFile program(argc > 2 ? argv[2] : "program.dcp");
+      program.Launch();
+    } catch (std::invalid_argument& err) {
+      std::cout << err.what();
+      return 0;
+    }
+    std::cout << "this is fine";
+    return 0;
+  }
   try {
+    Separator sep;
+    sep.unload("text.txt");
+#ifdef _DEBUG
+    sep.Dump("separated.txt");
+#endif
+    Compiler analyzer(std::move(sep.lexemes()));
     analyzer.Program();
+    analyzer.Optimize();
     analyzer.WritePoliz("poliz.txt");
     analyzer.Launch();
   }
@@ -1,7 +1,11 @@
 #pragma once
+#include <deque>
 #include <vector>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include "Poliz.h"
+#include "TypeDesc.h"
 /*!
  * \brief ,      
  *
@@ -15,11 +19,12 @@ class FunctionInfo {
    * 
    * @param type    
    * @param name  
-   * @param args  
+   * @param symbol   
+   * @param args   -      
    */
-  FunctionInfo(std::string type, std::string name,
-               std::vector<std::pair<std::string,std::string>> args)
-      : type_(type), name_(name), args_(args) {}
+  FunctionInfo(TypeDesc type, std::string name, int symbol,
+               std::vector<std::pair<TypeDesc, int>> args)
+      : type_(type), name_(name), symbol_(symbol), args_(args) {}
   /*!
    * @brief   
    */
@@ -28,22 +33,27 @@ class FunctionInfo {
    * @brief  type_
    * @return  type_
    */
-  std::string type() const { return type_; }
+  const TypeDesc& type() const { return type_; }
   /*!
    * @brief  type_
    * @param type   
    */
-  void set_type(std::string type) { type_ = type; }
+  void set_type(TypeDesc type) { type_ = type; }
   /*!
    * @brief  name_
    * @return  name_
    */
   std::string name() const { return name_; }
+  /*!
+   * @brief  symbol_
+   * @return  symbol_
+   */
+  int symbol() const { return symbol_; }
   /*!
    * @brief    
    * @return   args_
    */
-  std::vector<std::pair<std::string, std::string>> args() const {
+  const std::vector<std::pair<TypeDesc, int>>& args() const {
     return args_;
   }
   /*!
@@ -52,20 +62,71 @@ class FunctionInfo {
    */
   int poliz_start() const { return poliz_start_; }
   void set_poliz_start(int poliz_start) { poliz_start_ = poliz_start; }
-  void AddLocalVar(Var* var) { local_vars_.push_back(var); }
-  void AddArgument(Var* var) { arguments_.push_back(var); }
-
-  std::vector<Var*> arguments() const { return arguments_; }
-  std::vector<Var*> local_vars() const { return local_vars_; }
+  /*!
+   * @brief  frame_
+   * @return       .    
+   */
+  const std::vector<Var>& frame() const { return frame_; }
+  void set_frame(std::vector<Var> frame) { frame_ = std::move(frame); }
 
  private:
-  std::string type_;  ///<  .  
+  TypeDesc type_;     ///<  .  
   std::string name_;  ///<  
-  std::vector<std::pair<std::string, std::string>>
-      args_;         ///<  
+  int symbol_ = -1;   ///<   
+  std::vector<std::pair<TypeDesc, int>> args_;  ///<  
   int poliz_start_;  ///<      
-  std::vector<Var*> arguments_;
-  std::vector<Var*> local_vars_;
+  std::vector<Var> frame_;  ///<  :    
+};
+
+/*!
+ * \brief          
+ *
+ *    std::deque,       
+ *  .     ,   
+ * 
+ * @tparam Info FunctionInfo  StructInfo
+ */
+template <class Info>
+class Registry {
+ public:
+  /*!
+   * @brief    
+   * @param info  
+   * @return    
+   */
+  Info& Add(Info info) {
+    index_[info.symbol()] = items_.size();
+    items_.push_back(std::move(info));
+    return items_.back();
+  }
+  /*!
+   * @brief     
+   * @param symbol  
+   * @return     nullptr,   
+   */
+  const Info* Find(int symbol) const {
+    int index = IndexOf(symbol);
+    return index == -1 ? nullptr : &items_[index];
+  }
+  /*!
+   * @brief      
+   * @param symbol  
+   * @return       -1,   
+   */
+  int IndexOf(int symbol) const {
+    auto found = index_.find(symbol);
+    return found == index_.end() ? -1 : static_cast<int>(found->second);
+  }
+  /*!
+   * @brief  items_
+   * @return     
+   */
+  const std::deque<Info>& items() const { return items_; }
+  std::deque<Info>& items() { return items_; }
+
+ private:
+  std::deque<Info> items_;                 ///<  
+  std::unordered_map<int, size_t> index_;  ///<    
 };
 
 /*!
@@ -80,53 +141,51 @@ class StructInfo {
   /*!
    * @brief    ,    
    * @param type  
+   * @param symbol   
    */
-  StructInfo(std::string type = "") : typename_(type) {}
+  StructInfo(std::string type = "", int symbol = -1)
+      : typename_(type), symbol_(symbol) {}
   /*!
    * @brief  name_
    * @return  name_
    */
   std::string name() const { return typename_; }
+  /*!
+   * @brief  symbol_
+   * @return  symbol_
+   */
+  int symbol() const { return symbol_; }
   /*!
    * @brief    
    * @param func   
    */
-  void AddMethod(FunctionInfo func) { methods_.push_back(func); }
+  void AddMethod(FunctionInfo func) { methods_.Add(std::move(func)); }
   /*!
    * @brief    
    * @param type   
-   * @param name   
+   * @param name    
    */
-  void AddVariable(std::string type, std::string name) {
-    variables_.emplace_back(type, name);
-  }
+  void AddVariable(TypeDesc type, int name) { variables_[name] = type; }
   /*!
    * @brief      
-   * @param name   
-   * @return   ,   
-   */
-  std::string FindVariable(std::string name) const {
-    for (auto val : variables_) {
-      if (val.second == name) return val.first;
-    }
-    return "";
+   * @param name    
+   * @return       nullptr,   
+   */
+  const TypeDesc* FindVariable(int name) const {
+    auto found = variables_.find(name);
+    return found == variables_.end() ? nullptr : &found->second;
   }
   /*!
    * @brief    
-   * @param name   
-   * @return   .    -- , 
-   *  
-   */
-  FunctionInfo FindMethod(std::string name) const {
-    for (auto val : methods_) {
-      if (val.name() == name) return val;
-    }
-    return FunctionInfo();
-  }
+   * @param name    
+   * @return       nullptr,   
+   */
+  const FunctionInfo* FindMethod(int name) const { return methods_.Find(name); }
 
  private:
   std::string typename_;               ///<  
-  std::vector<FunctionInfo> methods_;  ///<   
-  std::vector<std::pair<std::string, std::string>>
-      variables_;  ///<   
+  int symbol_;                         ///<   
+  Registry<FunctionInfo> methods_;  ///<  
+  std::unordered_map<int, TypeDesc>
+      variables_;  ///<      
 };
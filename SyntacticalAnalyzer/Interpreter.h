@@ -1,7 +1,14 @@
 #pragma once
-#include <map>
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <iterator>
 #include <stack>
+#include <stdexcept>
+#include <string>
 #include "Poliz.h"
+#include "Bytecode.h"
 #include "ComponentsInfo.h"
 #include <iostream>
 /*!
@@ -9,40 +16,80 @@
 * @brief     
 */
 
+/*!
+ * @brief     goto  switch
+ *  goto -  GCC  Clang,        .    : -DDC_COMPUTED_GOTO=0  1
+*/
+#ifndef DC_COMPUTED_GOTO
+#if defined(__GNUC__) || defined(__clang__)
+#define DC_COMPUTED_GOTO 1
+#else
+#define DC_COMPUTED_GOTO 0
+#endif
+#endif
+
 
 /*!
  * @brief    
- *         ,   ,     .        ,        .
+ *         ,   ,     .       ,    ,   ,    .
 */
 class CallStackElem {
  public:
   /*!
    * @brief    
    * @param return_point  
-   * @param func_name  
+   * @param caller_base    ,   
+   * @param caller_frame       
   */
-  CallStackElem(int return_point, std::string func_name) : return_point_(return_point), func_name_(func_name) {}
+  CallStackElem(int return_point, size_t caller_base, size_t caller_frame)
+      : return_point_(return_point),
+        caller_base_(caller_base),
+        caller_frame_(caller_frame) {}
   /*!
    * @brief   return_point_
    * @return   return_point_
   */
   int return_point() const { return return_point_; }
   /*!
-   * @brief         
-   * @return     ,       
-  */
-  std::map<Var*, Var>& local_vars() { return local_vars_; }
-
+   * @brief   caller_base_
+   * @return   caller_base_
+   */
+  size_t caller_base() const { return caller_base_; }
   /*!
-   * @brief   func_name_
-   * @return   func_name_
+   * @brief   caller_frame_
+   * @return   caller_frame_
    */
-  std::string func_name() const { return func_name_; }
+  size_t caller_frame() const { return caller_frame_; }
 
  private:
-  std::map<Var*, Var> local_vars_; ///<   .    -  
   int return_point_; ///<   -   ,        
-  std::string func_name_; ///<  ,   
+  size_t caller_base_; ///<      ,    
+  size_t caller_frame_; ///<    ,    
+};
+
+/*!
+ * @brief   
+ *     .   - ,     :   ,    (, ++, --, )
+*/
+struct StackElem {
+  /*!
+   * @brief  -
+   * @param data 
+  */
+  StackElem(VarData data) : data_(std::move(data)) {}
+  /*!
+   * @brief  -
+   * @param var  
+  */
+  StackElem(Var* var) : data_(Int), var_(var) {}
+  /*!
+   * @brief  
+   * @return  ,   - ,   
+  */
+  const VarData& data() const { return var_ ? var_->data_ : data_; }
+
+  VarData data_; ///< ,   -  
+  Var* var_ = nullptr; ///<    nullptr
 };
 
 class Interpreter {
@@ -50,334 +97,689 @@ class Interpreter {
   /*!
    * @brief  
    * @param funcs  
-   * @param poliz ,   
+   * @param poliz ,   .       
+   * @param globals       
   */
-  Interpreter(std::vector<FunctionInfo> funcs, std::vector<PolizElem*> poliz)
+  Interpreter(const std::deque<FunctionInfo>& funcs, Bytecode& poliz,
+              const std::vector<Var>& globals)
       : funcs_(funcs),
         poliz_(poliz),
-        cur_func_("int", "main", std::vector<std::pair<std::string,std::string>>()) {}
+        code_(poliz.data()),
+        strings_(poliz.strings()),
+        globals_(globals) {
+    operands_.reserve(kOperandsReserve);
+    frames_.reserve(kFramesSize);
+    frame_ = frames_.data();
+    strings_.Seal();
+  }
+  /*!
+   * @brief  
+   * ,   ,         
+  */
+  ~Interpreter() {
+    operands_.clear();
+    frames_.clear();
+    globals_.clear();
+    CollectStrings();
+  }
 
   /*!
-   * @brief  
-   * @param start_ind   ,   
+   * @brief     ,  main  
+   * @param start_ind    ,   
   */
   void Launch(int start_ind) {
+    Run<DC_COMPUTED_GOTO != 0>(start_ind);
+    std::exit(0);
+  }
+
+  /*!
+   * @brief  ,  main   
+   *
+   *      switch,      .     goto ( GCC  Clang)          ,        ,    
+   * @tparam kThreaded   goto.  DC_COMPUTED_GOTO   - switch
+   * @param start_ind    ,   
+  */
+  template <bool kThreaded>
+  void Run(int start_ind) {
     cur_ind_ = start_ind;
+#if DC_COMPUTED_GOTO
+    static const void* const kLabels[] = {
+        &&op_Nop,       &&op_Var,       &&op_Local,     &&op_Const,
+        &&op_Jump,      &&op_JumpFalse, &&op_Call,      &&op_Return,
+        &&op_In,        &&op_Out,       &&op_PostInc,   &&op_PostDec,
+        &&op_PostNot,   &&op_Index,     &&op_PreInc,    &&op_PreDec,
+        &&op_PreNot,    &&op_UnPlus,    &&op_UnMinus,   &&op_Pow,
+        &&op_Mul,       &&op_Div,       &&op_Mod,       &&op_Add,
+        &&op_Sub,       &&op_Less,      &&op_LessEq,    &&op_Greater,
+        &&op_GreaterEq, &&op_Eq,        &&op_Ne,        &&op_And,
+        &&op_Or,        &&op_Assign,    &&op_AddAssign, &&op_SubAssign,
+        &&op_MulAssign, &&op_DivAssign, &&op_ModAssign, &&op_Comma,
+        &&op_Pop,
+        &&op_AddInt,       &&op_SubInt,       &&op_MulInt,
+        &&op_DivInt,       &&op_ModInt,       &&op_LessInt,
+        &&op_LessEqInt,    &&op_GreaterInt,   &&op_GreaterEqInt,
+        &&op_EqInt,        &&op_NeInt,        &&op_AssignInt,
+        &&op_AddAssignInt, &&op_SubAssignInt, &&op_AddFloat,
+        &&op_SubFloat,     &&op_MulFloat,     &&op_DivFloat,
+        &&op_ModFloat,     &&op_LessFloat,    &&op_LessEqFloat,
+        &&op_GreaterFloat, &&op_GreaterEqFloat, &&op_EqFloat,
+        &&op_NeFloat,      &&op_AssignFloat,  &&op_AddAssignFloat,
+        &&op_SubAssignFloat, &&op_Concat,     &&op_ToFloat,
+        &&op_Cast,         &&op_AndJump,      &&op_OrJump};
+    static_assert(std::size(kLabels) == static_cast<size_t>(OpCodes::Count),
+                  "every opcode needs a label");
+#define DC_OP(name) \
+  case OpCodes::name: \
+  op_##name:
+#define DC_NEXT                                                  \
+  if constexpr (kThreaded) goto* kLabels[code_[cur_ind_]]; \
+  break
+    if constexpr (kThreaded) goto* kLabels[code_[cur_ind_]];
+#else
+#define DC_OP(name) case OpCodes::name:
+#define DC_NEXT break
+#endif
     while (true) {
-      if (poliz_[cur_ind_]->type() != Oper &&
-          poliz_[cur_ind_]->type() != Func) {
-        operands_.push(poliz_[cur_ind_]);
-        cur_ind_++;
-      } else if (poliz_[cur_ind_]->type() == Oper) {
-        ProcessOper(dynamic_cast<PolizOper*>(poliz_[cur_ind_])->oper());
-      } else {
-        ProcessFunc(dynamic_cast<PolizFuncCall*>(poliz_[cur_ind_]),
-                    cur_ind_ + 1);
+      switch (static_cast<OpCodes>(code_[cur_ind_])) {
+        DC_OP(Nop) {
+          cur_ind_++;
+          DC_NEXT;
+        }
+        DC_OP(Var) {
+          operands_.emplace_back(&globals_[Operand()]);
+          cur_ind_ += 5;
+          DC_NEXT;
+        }
+        DC_OP(Local) {
+          operands_.emplace_back(frame_ + Operand());
+          cur_ind_ += 5;
+          DC_NEXT;
+        }
+        DC_OP(Const) {
+          operands_.emplace_back(poliz_.consts()[Operand()]);
+          cur_ind_ += 5;
+          DC_NEXT;
+        }
+        DC_OP(Jump) {
+          if (strings_.CollectDue()) CollectStrings();
+          cur_ind_ = Operand();
+          DC_NEXT;
+        }
+        DC_OP(JumpFalse) {
+          auto data = PopData();
+          if (data.Equal(VarData(false), strings_).bool_)
+            cur_ind_ = Operand();
+          else
+            cur_ind_ += 5;
+          DC_NEXT;
+        }
+        DC_OP(Call) {
+          uint32_t func;
+          std::memcpy(&func, code_ + cur_ind_ + 5, sizeof(func));
+          if (strings_.CollectDue()) CollectStrings();
+          ProcessFunc(funcs_[func], cur_ind_ + 9);
+          DC_NEXT;
+        }
+        DC_OP(Return) {
+          if (call_stack_.empty()) return;
+          ProcessReturn();
+          DC_NEXT;
+        }
+        DC_OP(In) {
+          cur_ind_++;
+          int n = PopData().int_;
+          for (size_t i = operands_.size() - n; i < operands_.size(); ++i) {
+            Read(std::cin, operands_[i].var_->data_, strings_);
+          }
+          operands_.resize(operands_.size() - n, StackElem(nullptr));
+          DC_NEXT;
+        }
+        DC_OP(Out) {
+          cur_ind_++;
+          int n = PopData().int_;
+          for (size_t i = operands_.size() - n; i < operands_.size(); ++i) {
+            Print(std::cout, operands_[i].data(), strings_);
+          }
+          operands_.resize(operands_.size() - n, StackElem(nullptr));
+          DC_NEXT;
+        }
+        DC_OP(PostInc) {
+          cur_ind_++;
+          auto var = operands_.back().var_;
+          operands_.emplace_back(var->data_);
+          var->data_.ApplyAssign(DataAdd, VarData(1), strings_);
+          DC_NEXT;
+        }
+        DC_OP(PostDec) {
+          cur_ind_++;
+          auto var = operands_.back().var_;
+          operands_.emplace_back(var->data_);
+          var->data_.ApplyAssign(DataSub, VarData(1), strings_);
+          DC_NEXT;
+        }
+        DC_OP(PostNot) {
+          cur_ind_++;
+          operands_.emplace_back(PopData().Factorial());
+          DC_NEXT;
+        }
+        DC_OP(Index) {
+          cur_ind_++;
+          VarData ind = PopData();
+          Var* arr = operands_.back().var_;
+          int ind_int;
+          if (ind.type_ == Int) ind_int = ind.int_;
+          if (ind.type_ == Bool) ind_int = ind.bool_;
+          if (ind.type_ == Char) ind_int = ind.char_;
+          if (ind.type_ == Float) ind_int = ind.float_;
+          if (ind_int >= arr->size_ || ind_int < 0) {
+            throw std::invalid_argument("Array index out of bounds");
+          } else {
+            operands_.emplace_back(arr + 1 + ind_int);
+          }
+          DC_NEXT;
+        }
+        DC_OP(PreInc) {
+          cur_ind_++;
+          auto var = operands_.back().var_;
+          var->data_.ApplyAssign(DataAdd, VarData(1), strings_);
+          operands_.emplace_back(var);
+          DC_NEXT;
+        }
+        DC_OP(PreDec) {
+          cur_ind_++;
+          auto var = operands_.back().var_;
+          var->data_.ApplyAssign(DataSub, VarData(1), strings_);
+          operands_.emplace_back(var);
+          DC_NEXT;
+        }
+        DC_OP(PreNot) {
+          cur_ind_++;
+          operands_.emplace_back(operands_.back().data().Negation());
+          DC_NEXT;
+        }
+        DC_OP(UnPlus) {
+          cur_ind_++;
+          operands_.emplace_back(operands_.back().data().UnPlus());
+          DC_NEXT;
+        }
+        DC_OP(UnMinus) {
+          cur_ind_++;
+          operands_.emplace_back(operands_.back().data().UnMinus());
+          DC_NEXT;
+        }
+        DC_OP(Pow) {
+          cur_ind_++;
+          Binary(DataPow);
+          DC_NEXT;
+        }
+        DC_OP(Mul) {
+          cur_ind_++;
+          Binary(DataMul);
+          DC_NEXT;
+        }
+        DC_OP(Div) {
+          cur_ind_++;
+          Binary(DataDiv);
+          DC_NEXT;
+        }
+        DC_OP(Mod) {
+          cur_ind_++;
+          Binary(DataMod);
+          DC_NEXT;
+        }
+        DC_OP(Add) {
+          cur_ind_++;
+          Binary(DataAdd);
+          DC_NEXT;
+        }
+        DC_OP(Sub) {
+          cur_ind_++;
+          Binary(DataSub);
+          DC_NEXT;
+        }
+        DC_OP(Less) {
+          cur_ind_++;
+          auto rhs = PopData();
+          operands_.emplace_back(PopData().Less(rhs, strings_));
+          DC_NEXT;
+        }
+        DC_OP(LessEq) {
+          cur_ind_++;
+          auto rhs = PopData();
+          operands_.emplace_back(PopData().LessEq(rhs, strings_));
+          DC_NEXT;
+        }
+        DC_OP(Greater) {
+          cur_ind_++;
+          auto rhs = PopData();
+          operands_.emplace_back(PopData().Greater(rhs, strings_));
+          DC_NEXT;
+        }
+        DC_OP(GreaterEq) {
+          cur_ind_++;
+          auto rhs = PopData();
+          operands_.emplace_back(PopData().GreaterEq(rhs, strings_));
+          DC_NEXT;
+        }
+        DC_OP(Eq) {
+          cur_ind_++;
+          auto rhs = PopData();
+          operands_.emplace_back(PopData().Equal(rhs, strings_));
+          DC_NEXT;
+        }
+        DC_OP(Ne) {
+          cur_ind_++;
+          auto rhs = PopData();
+          operands_.emplace_back(PopData().NotEqual(rhs, strings_));
+          DC_NEXT;
+        }
+        DC_OP(And) {
+          cur_ind_++;
+          Binary(DataAnd);
+          DC_NEXT;
+        }
+        DC_OP(Or) {
+          cur_ind_++;
+          Binary(DataOr);
+          DC_NEXT;
+        }
+        DC_OP(Assign) {
+          cur_ind_++;
+          auto rhs = PopData();
+          auto var = operands_.back().var_;
+          var->data_.Assign(rhs, strings_);
+          operands_.emplace_back(var);
+          DC_NEXT;
+        }
+        DC_OP(AddAssign) {
+          cur_ind_++;
+          auto rhs = PopData();
+          auto var = operands_.back().var_;
+          var->data_.ApplyAssign(DataAdd, rhs, strings_);
+          operands_.emplace_back(var);
+          DC_NEXT;
+        }
+        DC_OP(SubAssign) {
+          cur_ind_++;
+          auto rhs = PopData();
+          auto var = operands_.back().var_;
+          var->data_.ApplyAssign(DataSub, rhs, strings_);
+          operands_.emplace_back(var);
+          DC_NEXT;
+        }
+        DC_OP(MulAssign) {
+          cur_ind_++;
+          auto rhs = PopData();
+          auto var = operands_.back().var_;
+          var->data_.ApplyAssign(DataMul, rhs, strings_);
+          operands_.emplace_back(var);
+          DC_NEXT;
+        }
+        DC_OP(DivAssign) {
+          cur_ind_++;
+          auto rhs = PopData();
+          auto var = operands_.back().var_;
+          var->data_.ApplyAssign(DataDiv, rhs, strings_);
+          operands_.emplace_back(var);
+          DC_NEXT;
+        }
+        DC_OP(ModAssign) {
+          cur_ind_++;
+          auto rhs = PopData();
+          auto var = operands_.back().var_;
+          var->data_.ApplyAssign(DataMod, rhs, strings_);
+          operands_.emplace_back(var);
+          DC_NEXT;
+        }
+        DC_OP(Comma) {
+          cur_ind_++;
+          DC_NEXT;
+        }
+        DC_OP(Pop) {
+          cur_ind_++;
+          //  ,  ,      ,
+          //   ,       
+          operands_.pop_back();
+          if (operands_.size() > frame_base_) {
+            operands_.erase(operands_.begin() + frame_base_, operands_.end());
+          }
+          DC_NEXT;
+        }
+        //         
+        // ,    .  float   <,  
+        // VarData,    NaN   
+        DC_OP(AddInt) {
+          cur_ind_++;
+          IntBinary([](int a, int b) { return a + b; });
+          DC_NEXT;
+        }
+        DC_OP(SubInt) {
+          cur_ind_++;
+          IntBinary([](int a, int b) { return a - b; });
+          DC_NEXT;
+        }
+        DC_OP(MulInt) {
+          cur_ind_++;
+          IntBinary([](int a, int b) { return a * b; });
+          DC_NEXT;
+        }
+        DC_OP(DivInt) {
+          cur_ind_++;
+          IntBinary([](int a, int b) { return a / b; });
+          DC_NEXT;
+        }
+        DC_OP(ModInt) {
+          cur_ind_++;
+          IntBinary([](int a, int b) { return a % b; });
+          DC_NEXT;
+        }
+        DC_OP(LessInt) {
+          cur_ind_++;
+          IntBinary([](int a, int b) { return a < b; });
+          DC_NEXT;
+        }
+        DC_OP(LessEqInt) {
+          cur_ind_++;
+          IntBinary([](int a, int b) { return a <= b; });
+          DC_NEXT;
+        }
+        DC_OP(GreaterInt) {
+          cur_ind_++;
+          IntBinary([](int a, int b) { return a > b; });
+          DC_NEXT;
+        }
+        DC_OP(GreaterEqInt) {
+          cur_ind_++;
+          IntBinary([](int a, int b) { return a >= b; });
+          DC_NEXT;
+        }
+        DC_OP(EqInt) {
+          cur_ind_++;
+          IntBinary([](int a, int b) { return a == b; });
+          DC_NEXT;
+        }
+        DC_OP(NeInt) {
+          cur_ind_++;
+          IntBinary([](int a, int b) { return a != b; });
+          DC_NEXT;
+        }
+        DC_OP(AssignInt) {
+          cur_ind_++;
+          IntAssign([](int, int b) { return b; });
+          DC_NEXT;
+        }
+        DC_OP(AddAssignInt) {
+          cur_ind_++;
+          IntAssign([](int a, int b) { return a + b; });
+          DC_NEXT;
+        }
+        DC_OP(SubAssignInt) {
+          cur_ind_++;
+          IntAssign([](int a, int b) { return a - b; });
+          DC_NEXT;
+        }
+        DC_OP(AddFloat) {
+          cur_ind_++;
+          FloatBinary([](float a, float b) { return a + b; });
+          DC_NEXT;
+        }
+        DC_OP(SubFloat) {
+          cur_ind_++;
+          FloatBinary([](float a, float b) { return a - b; });
+          DC_NEXT;
+        }
+        DC_OP(MulFloat) {
+          cur_ind_++;
+          FloatBinary([](float a, float b) { return a * b; });
+          DC_NEXT;
+        }
+        DC_OP(DivFloat) {
+          cur_ind_++;
+          FloatBinary([](float a, float b) { return a / b; });
+          DC_NEXT;
+        }
+        DC_OP(ModFloat) {
+          cur_ind_++;
+          FloatBinary([](float a, float b) { return std::fmod(a, b); });
+          DC_NEXT;
+        }
+        DC_OP(LessFloat) {
+          cur_ind_++;
+          FloatBinary([](float a, float b) { return a < b; });
+          DC_NEXT;
+        }
+        DC_OP(LessEqFloat) {
+          cur_ind_++;
+          FloatBinary([](float a, float b) { return !(b < a); });
+          DC_NEXT;
+        }
+        DC_OP(GreaterFloat) {
+          cur_ind_++;
+          FloatBinary([](float a, float b) { return b < a; });
+          DC_NEXT;
+        }
+        DC_OP(GreaterEqFloat) {
+          cur_ind_++;
+          FloatBinary([](float a, float b) { return !(a < b); });
+          DC_NEXT;
+        }
+        DC_OP(EqFloat) {
+          cur_ind_++;
+          FloatBinary([](float a, float b) { return !(a < b) && !(b < a); });
+          DC_NEXT;
+        }
+        DC_OP(NeFloat) {
+          cur_ind_++;
+          FloatBinary([](float a, float b) { return a < b || b < a; });
+          DC_NEXT;
+        }
+        DC_OP(AssignFloat) {
+          cur_ind_++;
+          FloatAssign([](float, float b) { return b; });
+          DC_NEXT;
+        }
+        DC_OP(AddAssignFloat) {
+          cur_ind_++;
+          FloatAssign([](float a, float b) { return a + b; });
+          DC_NEXT;
+        }
+        DC_OP(SubAssignFloat) {
+          cur_ind_++;
+          FloatAssign([](float a, float b) { return a - b; });
+          DC_NEXT;
+        }
+        DC_OP(Concat) {
+          cur_ind_++;
+          auto rhs = PopData();
+          StackElem& lhs = operands_.back();
+          lhs = StackElem(VarData(
+              strings_, lhs.data().str(strings_) + rhs.str(strings_)));
+          DC_NEXT;
+        }
+        DC_OP(ToFloat) {
+          StackElem& elem = operands_[operands_.size() - 1 - Operand()];
+          elem = StackElem(VarData(static_cast<float>(elem.data().int_)));
+          cur_ind_ += 5;
+          DC_NEXT;
+        }
+        DC_OP(Cast) {
+          VarData res(static_cast<VarTypes>(Operand()));
+          res.Assign(operands_.back().data(), strings_);
+          operands_.back() = StackElem(res);
+          cur_ind_ += 5;
+          DC_NEXT;
+        }
+        DC_OP(AndJump) {
+          StackElem& top = operands_.back();
+          if (top.data().Equal(VarData(false), strings_).bool_) {
+            top = StackElem(VarData(false));
+            cur_ind_ = Operand();
+          } else {
+            operands_.pop_back();
+            cur_ind_ += 5;
+          }
+          DC_NEXT;
+        }
+        DC_OP(OrJump) {
+          StackElem& top = operands_.back();
+          if (top.data().Equal(VarData(false), strings_).bool_) {
+            operands_.pop_back();
+            cur_ind_ += 5;
+          } else {
+            top = StackElem(VarData(true));
+            cur_ind_ = Operand();
+          }
+          DC_NEXT;
+        }
+        default:
+          throw std::invalid_argument("Unknown operation code " +
+                                      std::to_string(code_[cur_ind_]));
       }
     }
+#undef DC_OP
+#undef DC_NEXT
   }
 
  private:
   std::stack<CallStackElem> call_stack_; ///<  
-  std::vector<FunctionInfo> funcs_; ///<  
-  std::vector<PolizElem*> poliz_; ///< 
-  std::stack<PolizElem*> operands_; ///<  
-  FunctionInfo cur_func_; ///<   
-  int cur_ind_; ///<    
+  const std::deque<FunctionInfo>& funcs_; ///<  
+  const Bytecode& poliz_; ///< 
+  const uint8_t* code_; ///<  
+  StringHeap& strings_; ///<  
+  //!      
+  static constexpr size_t kOperandsReserve = 1024;
+  //!      .     ,        
+  static constexpr size_t kFramesSize = 1 << 20;
+  std::vector<Var> globals_; ///<     
+  std::vector<Var> frames_; ///<    .  ,        
+  Var* frame_; ///<    
+  std::vector<StackElem> operands_; ///<  
+  size_t frame_base_ = 0; ///<    ,   .      
+  int cur_ind_; ///<     
 
   /*!
-   * @brief      ,    PolizLit  PolizVar
-   * @return     
+   * @brief   
+   * @return  4-    
   */
-  VarData& PopData() {
-    if (operands_.top()->type()==Variable) {
-      VarData& tmp = dynamic_cast<PolizVar*>(operands_.top())->var()->data_;
-      operands_.pop();
-      return tmp;
-    } else {
-      VarData& tmp = dynamic_cast<PolizLit*>(operands_.top())->data_;
-      operands_.pop();
-      return tmp;
-    }
+  uint32_t Operand() const {
+    uint32_t res;
+    std::memcpy(&res, code_ + cur_ind_ + 1, sizeof(res));
+    return res;
   }
 
   /*!
-   * @brief     ,      
-   * @return    
+   * @brief      ,     ,    
+   *   ,       globals_, frames_  operands_.           ,        
   */
-  int PopAddress() {
-    int res = dynamic_cast<PolizAddress*>(operands_.top())->address();
-    operands_.pop();
-    return res;
+  void CollectStrings() {
+    auto mark = [this](const VarData& data) {
+      if (data.type_ == String) strings_.Mark(data.string_);
+    };
+    for (const Var& var : globals_) mark(var.data_);
+    for (const Var& var : frames_) mark(var.data_);
+    for (const StackElem& elem : operands_) mark(elem.data_);
+    strings_.Sweep();
   }
 
   /*!
-   * @brief   
-   * @param oper ,   
+   * @brief      
+   * @return   :     
   */
-  void ProcessOper(std::string oper) {
-    if (oper == "B!") {
-      cur_ind_ = PopAddress();
-      return;
-    }
-    if (oper == "F!") {
-      int address = PopAddress();
-      auto data = PopData();
-      if ((data == VarData(false)).bool_)
-        cur_ind_ = address;
-      else
-        cur_ind_++;
-      return;
-    }
-    if (oper == "return") {
-      if (call_stack_.empty()) {
-        std::exit(0);
-      }
-
-      auto data = PopData();
-      operands_.push(new PolizLit(data));
-      cur_ind_ = call_stack_.top().return_point();
-
-      call_stack_.pop();
+  VarData PopData() {
+    StackElem& top = operands_.back();
+    VarData res = top.var_ ? top.var_->data_ : std::move(top.data_);
+    operands_.pop_back();
+    return res;
+  }
 
-      if (!call_stack_.empty()) {
-        for (auto& val : call_stack_.top().local_vars()) {
-          *val.first = val.second;
-        }
+  /*!
+   * @brief         
+   * @param oper 
+  */
+  void Binary(DataOpers oper) {
+    auto rhs = PopData();
+    operands_.emplace_back(PopData().Apply(oper, rhs, strings_));
+  }
+  /*!
+   * @brief     int    
+   * @param op ,  int  bool
+  */
+  template <class Op>
+  void IntBinary(Op op) {
+    int rhs = PopData().int_;
+    StackElem& lhs = operands_.back();
+    lhs = StackElem(VarData(op(lhs.data().int_, rhs)));
+  }
+  /*!
+   * @brief     float    
+   * @param op ,  float  bool
+  */
+  template <class Op>
+  void FloatBinary(Op op) {
+    float rhs = PopData().float_;
+    StackElem& lhs = operands_.back();
+    lhs = StackElem(VarData(op(lhs.data().float_, rhs)));
+  }
+  /*!
+   * @brief   int:    ,      ,    Assign
+   * @param op       
+  */
+  template <class Op>
+  void IntAssign(Op op) {
+    int rhs = PopData().int_;
+    Var* var = operands_.back().var_;
+    var->data_.int_ = op(var->data_.int_, rhs);
+    operands_.emplace_back(var);
+  }
+  /*!
+   * @brief   float,  IntAssign
+   * @param op       
+  */
+  template <class Op>
+  void FloatAssign(Op op) {
+    float rhs = PopData().float_;
+    Var* var = operands_.back().var_;
+    var->data_.float_ = op(var->data_.float_, rhs);
+    operands_.emplace_back(var);
+  }
 
-        for (auto& val : funcs_) {
-          if (val.name() == call_stack_.top().func_name()) {
-            cur_func_ = val;
-            break;
-          }
-        }
-      }
-      return;
-    }
-    cur_ind_++;
-    if (oper == "in") {
-      int n = PopData().int_;
-      std::stack<Var*> elems;
-      for (int i = 0; i < n; ++i) {
-        elems.push(dynamic_cast<PolizVar*>(operands_.top())->var());
-        operands_.pop();
-      }
-      while (!elems.empty()) {
-        std::cin >> elems.top()->data_;
-        elems.pop();
-      }
-    }
-    if (oper == "out") {
-      int n = PopData().int_;
-      std::stack<VarData> elems;
-      for (int i = 0; i < n; ++i) {
-        elems.push(PopData());
-      }
-      while (!elems.empty()) {
-        std::cout << elems.top();
-        elems.pop();
-      }
-    }
-    if (oper == "post++") {
-      auto var = dynamic_cast<PolizVar*>(operands_.top())->var();
-      operands_.push(new PolizLit(var->data_));
-      var->data_ += VarData(1);
-    }
-    if (oper == "post--") {
-      auto var = dynamic_cast<PolizVar*>(operands_.top())->var();
-      operands_.push(new PolizLit(var->data_));
-      var->data_ -= VarData(1);
-    }
-    if (oper == "[]") {
-      VarData ind = PopData();
-      Var* arr = dynamic_cast<PolizVar*>(operands_.top())->var();
-      int ind_int;
-      if (ind.type_ == Int) ind_int = ind.int_;
-      if (ind.type_ == Bool) ind_int = ind.bool_;
-      if (ind.type_ == Char) ind_int = ind.char_;
-      if (ind.type_ == Float) ind_int = ind.float_;
-      if (ind_int >= arr->array_.size() || ind_int < 0) {
-        throw std::invalid_argument("Array index out of bounds");
-      } else {
-        operands_.push(new PolizVar(arr->array_[ind_int]));
-      }
-    }
-    if (oper == "post!") {
-      operands_.push(new PolizLit(PopData().Factorial()));
-    }
-    if (oper == "pre++") {
-      auto var = dynamic_cast<PolizVar*>(operands_.top())->var();
-      var->data_ += VarData(1);
-      operands_.push(new PolizVar(var));
-    }
-    if (oper == "pre--") {
-      auto var = dynamic_cast<PolizVar*>(operands_.top())->var();
-      var->data_ -= VarData(1);
-      operands_.push(new PolizVar(var));
-    }
-    if (oper == "un+") {
-      auto var = dynamic_cast<PolizVar*>(operands_.top())->var();
-      operands_.push(new PolizLit(var->data_.UnPlus()));
-    }
-    if (oper == "un-") {
-      auto var = dynamic_cast<PolizVar*>(operands_.top())->var();
-      operands_.push(new PolizLit(var->data_.UnMinus()));
-    }
-    if (oper == "pre!") {
-      auto var = dynamic_cast<PolizVar*>(operands_.top())->var();
-      operands_.push(new PolizLit(var->data_.Negation()));
-    }
-    if (oper == "**") {
-      auto rhs = PopData();
-      operands_.push(new PolizLit(PopData().Power(rhs)));
-    }
-    if (oper == "*") {
-      operands_.push(new PolizLit(PopData() * PopData()));
-    }
-    if (oper == "/") {
-      auto rhs = PopData();
-      operands_.push(new PolizLit(PopData() / rhs));
-    }
-    if (oper == "%") {
-      auto rhs = PopData();
-      operands_.push(new PolizLit(PopData() % rhs));
-    }
-    if (oper == "+") {
-      operands_.push(new PolizLit(PopData() + PopData()));
-    }
-    if (oper == "-") {
-      auto rhs = PopData();
-      operands_.push(new PolizLit(PopData() - rhs));
-    }
-    if (oper == "<") {
-      auto rhs = PopData();
-      operands_.push(new PolizLit(PopData() < rhs));
-    }
-    if (oper == "<=") {
-      auto rhs = PopData();
-      operands_.push(new PolizLit(PopData() <= rhs));
-    }
-    if (oper == ">") {
-      auto rhs = PopData();
-      operands_.push(new PolizLit(PopData() > rhs));
-    }
-    if (oper == ">=") {
-      auto rhs = PopData();
-      operands_.push(new PolizLit(PopData() >= rhs));
-    }
-    if (oper == "==") {
-      auto rhs = PopData();
-      operands_.push(new PolizLit(PopData() == rhs));
-    }
-    if (oper == "!=") {
-      auto rhs = PopData();
-      operands_.push(new PolizLit(PopData() != rhs));
-    }
-    if (oper == "&&") {
-      auto rhs = PopData();
-      operands_.push(new PolizLit(PopData() && rhs));
-    }
-    if (oper == "||") {
-      auto rhs = PopData();
-      operands_.push(new PolizLit(PopData() || rhs));
-    }
-    if (oper == "=") {
-      auto rhs = PopData();
-      auto var = dynamic_cast<PolizVar*>(operands_.top())->var();
-      var->data_ = rhs;
-      operands_.push(new PolizVar(var));
-    }
-    if (oper == "+=") {
-      auto rhs = PopData();
-      auto var = dynamic_cast<PolizVar*>(operands_.top())->var();
-      var->data_ += rhs;
-      operands_.push(new PolizVar(var));
-    }
-    if (oper == "-=") {
-      auto rhs = PopData();
-      auto var = dynamic_cast<PolizVar*>(operands_.top())->var();
-      var->data_ -= rhs;
-      operands_.push(new PolizVar(var));
-    }
-    if (oper == "*=") {
-      auto rhs = PopData();
-      auto var = dynamic_cast<PolizVar*>(operands_.top())->var();
-      var->data_ *= rhs;
-      operands_.push(new PolizVar(var));
-    }
-    if (oper == "/=") {
-      auto rhs = PopData();
-      auto var = dynamic_cast<PolizVar*>(operands_.top())->var();
-      var->data_ /= rhs;
-      operands_.push(new PolizVar(var));
-    }
-    if (oper == "%=") {
-      auto rhs = PopData();
-      auto var = dynamic_cast<PolizVar*>(operands_.top())->var();
-      var->data_ %= rhs;
-      operands_.push(new PolizVar(var));
-    }
-    if (oper == ",") {
-      auto tmp = operands_.top();
-      operands_.pop();
-      operands_.push(tmp);
-    }
-    if (oper == ";") {
-      PopData();
-    }
+  /*!
+   * @brief    
+   *      ,      
+  */
+  void ProcessReturn() {
+    auto data = PopData();
+    operands_.emplace_back(data);
+    const CallStackElem& caller = call_stack_.top();
+    cur_ind_ = caller.return_point();
+    frame_base_ = caller.caller_base();
+    frames_.resize(frame_ - frames_.data());
+    frame_ = frames_.data() + caller.caller_frame();
+    call_stack_.pop();
   }
 
   /*!
    * @brief      
-   * @param func_call   
+   *          ,       
+   * @param func  
    * @param return_point    
+   * @throw std::invalid_argument    
   */
-  void ProcessFunc(PolizFuncCall* func_call, int return_point) {
-    if (cur_func_.name() != "main") {
-      for (auto& val : cur_func_.local_vars()) {
-        if (!val->array_.empty()) {
-          for (auto& var : val->array_) {
-            call_stack_.top().local_vars()[var] = *var;
-          }
-        } else {
-          call_stack_.top().local_vars()[val] = *val;
-        }
-      }
-      for (auto& val : cur_func_.arguments()) {
-        if (!val->array_.empty()) {
-          for (auto& var : val->array_) {
-            call_stack_.top().local_vars()[var] = *var;
-          }
-        } else {
-          call_stack_.top().local_vars()[val] = *val;
-        }
-      }
+  void ProcessFunc(const FunctionInfo& func, int return_point) {
+    const std::vector<Var>& frame = func.frame();
+    if (frames_.capacity() - frames_.size() < frame.size()) {
+      throw std::invalid_argument("Stack overflow");
     }
-
-    call_stack_.emplace(return_point, func_call->func_name());
-
-    for (auto& val : funcs_) {
-      if (val.name() == func_call->func_name()) {
-        std::stack<VarData> data_stack;
-        for (int i = 0; i < val.arguments().size(); ++i) {
-          data_stack.push(PopData());
-        }
-
-        for (auto&var:val.arguments()) {
-          var->data_ = data_stack.top();
-          data_stack.pop();
-        }
-
-        for (auto& var : val.local_vars()) {
-          var->data_ = VarData(var->data_.type_);
-        }
-
-        cur_ind_ = val.poliz_start();
-
-        cur_func_ = val;
-
-        break;
-      }
+    size_t base = frames_.size();
+    frames_.insert(frames_.end(), frame.begin(), frame.end());
+    Var* args = frames_.data() + base;
+    for (size_t i = func.args().size(); i-- > 0;) {
+      args[i].data_.Assign(PopData(), strings_);
     }
+
+    call_stack_.emplace(return_point, frame_base_, frame_ - frames_.data());
+    frame_ = args;
+    frame_base_ = operands_.size();
+    cur_ind_ = func.poliz_start();
   }
 };
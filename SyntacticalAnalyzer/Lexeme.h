@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <string_view>
 /*!
  * \file
  * \brief       
@@ -36,16 +37,17 @@ enum LexemeTypes {
  *
  *       ,      ,
  *    .      
- *  
+ *  .     -   
+ *  ,   TokenBuffer
  */
 class Lexeme {
  public:
   /*!
    * @brief    ,    ,   
-   * 
+   * ,  ,   - 
    */
-  Lexeme(LexemeTypes type, std::string text, int line)
-      : type_(type), text_(text), line_(line) {}
+  Lexeme(LexemeTypes type, std::string_view text, int line, int symbol = -1)
+      : type_(type), text_(text), line_(line), symbol_(symbol) {}
   /*!
    * @brief   
    *      ,  - keyword
@@ -61,21 +63,27 @@ class Lexeme {
    * @brief  text_
    * @return text_
    */
-  std::string text() const { return text_; }
+  std::string_view text() const { return text_; }
   /*!
    * @brief  line_
    * @return line_
    */
   int line() const { return line_; }
-  friend bool operator==(Lexeme& lhs, const char* str);
-  friend bool operator==(const char* lhs, Lexeme& str);
-  friend bool operator!=(Lexeme& lhs, const char* str);
-  friend bool operator!=(const char* lhs, Lexeme& str);
+  /*!
+   * @brief  symbol_
+   * @return symbol_
+   */
+  int symbol() const { return symbol_; }
+  friend bool operator==(const Lexeme& lhs, const char* str);
+  friend bool operator==(const char* lhs, const Lexeme& str);
+  friend bool operator!=(const Lexeme& lhs, const char* str);
+  friend bool operator!=(const char* lhs, const Lexeme& str);
 
  private:
   LexemeTypes type_;  ///<  
-  std::string text_;  ///<  
+  std::string_view text_;  ///<  
   int line_;  ///<     
+  int symbol_ = -1;  ///<    SymbolTable, -1   
 };
 
 /*!
@@ -85,13 +93,13 @@ class Lexeme {
  * @return true  false 
  *     
  */
-bool operator==(Lexeme& lhs, const char* str) { return lhs.text_ == str; }
-bool operator==(const char* lhs, Lexeme& str) { return lhs == str.text_; }
+bool operator==(const Lexeme& lhs, const char* str) { return lhs.text_ == str; }
+bool operator==(const char* lhs, const Lexeme& str) { return lhs == str.text_; }
 /*!
  * @brief  ,    ==,  
  * @param lhs
  * @param str
  * @return true  false 
  */
-bool operator!=(Lexeme& lhs, const char* str) { return lhs.text_ != str; }
-bool operator!=(const char* lhs, Lexeme& str) { return lhs != str.text_; }
+bool operator!=(const Lexeme& lhs, const char* str) { return lhs.text_ != str; }
+bool operator!=(const char* lhs, const Lexeme& str) { return lhs != str.text_; }
@@ -0,0 +1,108 @@
+#pragma once
+#include <string_view>
+#include "Lexeme.h"
+/*!
+ * \file
+ * \brief       
+ *
+ *         
+ * ,        
+ *   
+ */
+
+/*!
+ * @brief  :     
+ */
+struct TableEntry {
+  std::string_view text;  ///<  
+  LexemeTypes type;       ///<  
+};
+
+/*!
+ * @brief -       
+ *
+ *           . 
+ *  ,       ,  
+ *   
+ * @tparam N  
+ */
+template <int N>
+class PerfectHashTable {
+ public:
+  /*!
+   * @brief     
+   * @param entries  
+   * @param a   
+   * @param b   
+   * @param c   
+   */
+  template <int M>
+  constexpr PerfectHashTable(const TableEntry (&entries)[M], unsigned a,
+                             unsigned b, unsigned c)
+      : a_(a), b_(b), c_(c) {
+    for (auto& entry : entries) {
+      auto& slot = slots_[Hash(entry.text)];
+      if (!slot.text.empty()) collision_ = true;
+      slot = entry;
+    }
+  }
+  /*!
+   * @brief    
+   * @param text  
+   * @return      nullptr
+   */
+  constexpr const TableEntry* Find(std::string_view text) const {
+    if (text.empty()) return nullptr;
+    auto& slot = slots_[Hash(text)];
+    return slot.text == text ? &slot : nullptr;
+  }
+  /*!
+   * @brief ,       
+   */
+  constexpr bool collision() const { return collision_; }
+
+ private:
+  constexpr unsigned Hash(std::string_view text) const {
+    return (static_cast<unsigned char>(text.front()) * a_ +
+            static_cast<unsigned char>(text.back()) * b_ + text.size() * c_) %
+           N;
+  }
+
+  unsigned a_, b_, c_;  ///<  -
+  TableEntry slots_[N] = {};  ///<  
+  bool collision_ = false;  ///<     
+};
+
+//!   
+constexpr TableEntry kReservedWords[] = {
+    {"if", Keyword},     {"for", Keyword},    {"float", Keyword},
+    {"while", Keyword},  {"do", Keyword},     {"return", Keyword},
+    {"auto", Keyword},   {"int", Keyword},    {"struct", Keyword},
+    {"break", Keyword},  {"continue", Keyword}, {"bool", Keyword},
+    {"void", Keyword},   {"in", Keyword},     {"out", Keyword},
+    {"else", Keyword},   {"true", BoolLit},   {"false", BoolLit},
+    {"string", Keyword}};
+
+/*!
+ *     . ++, --  !   0 - 
+ *       
+ */
+constexpr TableEntry kOperations[] = {
+    {".", Priority0},   {"++", Priority0},  {"--", Priority0},
+    {"!", Priority0},   {"**", Priority2},  {"/", Priority3},
+    {"*", Priority3},   {"%", Priority3},   {"+", Priority4},
+    {"-", Priority4},   {"<", Priority5},   {">", Priority5},
+    {"<=", Priority5},  {">=", Priority5},  {"==", Priority6},
+    {"!=", Priority6},  {"&&", Priority7},  {"||", Priority8},
+    {"^", Priority8},   {"+=", Priority9},  {"*=", Priority9},
+    {"=", Priority9},   {"-=", Priority9},  {"/=", Priority9},
+    {"%=", Priority9},  {",", Priority10}};
+
+//!   
+constexpr PerfectHashTable<32> kReservedTable(kReservedWords, 1, 27, 2);
+//!  
+constexpr PerfectHashTable<64> kOperationsTable(kOperations, 1, 2, 39);
+
+static_assert(!kReservedTable.collision(),
+              "Collision in the reserved words table");
+static_assert(!kOperationsTable.collision(), "Collision in the operations table");
@@ -0,0 +1,105 @@
+#pragma once
+#include <stdexcept>
+#include <string>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+/*!
+ * \file
+ * \brief    ,   
+ */
+
+/*!
+ * \brief ,      
+ *
+ *         .
+ *    
+ */
+class MappedFile {
+ public:
+  /*!
+   * @brief    
+   * @param file_name   
+   * @throw std::invalid_argument     
+   */
+  explicit MappedFile(const std::string& file_name) {
+#ifdef _WIN32
+    file_ = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE) {
+      throw std::invalid_argument("Can't open file " + file_name);
+    }
+    LARGE_INTEGER size;
+    GetFileSizeEx(file_, &size);
+    size_ = static_cast<size_t>(size.QuadPart);
+    if (size_ > 0) {
+      mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+      data_ = static_cast<const char*>(
+          MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    }
+#else
+    fd_ = open(file_name.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+      throw std::invalid_argument("Can't open file " + file_name);
+    }
+    struct stat info;
+    fstat(fd_, &info);
+    size_ = static_cast<size_t>(info.st_size);
+    if (size_ > 0) {
+      void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+      if (data != MAP_FAILED) {
+        madvise(data, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(data);
+      }
+    }
+#endif
+    if (size_ > 0 && data_ == nullptr) {
+      throw std::invalid_argument("Can't map file " + file_name);
+    }
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /*!
+   * @brief     
+   */
+  ~MappedFile() {
+#ifdef _WIN32
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_) CloseHandle(mapping_);
+    CloseHandle(file_);
+#else
+    if (data_) munmap(const_cast<char*>(data_), size_);
+    close(fd_);
+#endif
+  }
+
+  /*!
+   * @brief  data_
+   * @return     
+   */
+  const char* data() const { return data_; }
+  /*!
+   * @brief  size_
+   * @return    
+   */
+  size_t size() const { return size_; }
+
+ private:
+  const char* data_ = nullptr;  ///<   
+  size_t size_ = 0;             ///<  
+#ifdef _WIN32
+  HANDLE file_;              ///<  
+  HANDLE mapping_ = nullptr;  ///<  
+#else
+  int fd_;  ///<   
+#endif
+};
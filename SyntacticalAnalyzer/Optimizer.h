@@ -0,0 +1,655 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "Bytecode.h"
+#include "ComponentsInfo.h"
+#include "Poliz.h"
+/*!
+ * \file
+ * \brief      
+ */
+
+/*!
+ * @brief   
+ */
+struct OptimizeStats {
+  size_t instructions = 0;  ///<       
+  size_t eliminated = 0;  ///<   
+  size_t propagated = 0;  ///<     
+};
+
+/*!
+ * \brief      
+ *
+ *      . ,  
+ *  -   ,    VarData  
+ *     . ,   
+ *       ,  ,  
+ *    .    
+ *    
+ *
+ *  ,      - 
+ *    main       , -
+ *  ,   ,  ,  
+ * .       
+ * ,       
+ *
+ *        ,  ,
+ *    ,       , 
+ *     
+ */
+class Optimizer {
+ public:
+  /*!
+   * @brief     
+   * @param code ,  
+   * @param funcs  ,    
+   * @param globals     
+   * @param entry   main, 
+   */
+  Optimizer(Bytecode& code, std::deque<FunctionInfo>& funcs,
+            const std::vector<Var>& globals, int& entry)
+      : code_(code),
+        funcs_(funcs),
+        globals_(globals),
+        entry_(entry),
+        consts_(code.consts()) {}
+
+  /*!
+   * @brief  
+   * @return  
+   */
+  OptimizeStats Run() {
+    Decode();
+    OptimizeStats stats;
+    stats.instructions = instrs_.size();
+    Fold();
+    for (size_t replaced; (replaced = Propagate()) != 0;) {
+      stats.propagated += replaced;
+      Fold();
+    }
+    stats.eliminated = stats.instructions - instrs_.size();
+    Encode();
+    return stats;
+  }
+
+ private:
+  /*!
+   * @brief    
+   */
+  struct Instr {
+    OpCodes op;
+    uint32_t first = 0;   ///<  
+    uint32_t second = 0;  ///<  
+    size_t pos = 0;       ///<     
+    bool target = false;  ///<         
+  };
+  /*!
+   * @brief       
+   */
+  struct Entry {
+    int slot = -1;  ///<     -1,    
+    int producer = -1;  ///<  ,  
+  };
+  /*!
+   * @brief       
+   */
+  struct State {
+    std::vector<Entry> stack;  ///<   
+    bool unknown = false;  ///<       - 
+  };
+
+  Bytecode& code_;  ///<  
+  std::deque<FunctionInfo>& funcs_;  ///<  
+  const std::vector<Var>& globals_;  ///<  
+  int& entry_;  ///<   main
+  std::vector<VarData> consts_;  ///<  ,   
+  std::vector<Instr> instrs_;  ///<    
+
+  /*!
+   * @brief     
+   */
+  void Decode() {
+    for (size_t pos = 0; pos < code_.size();) {
+      Instr cur{code_.op(pos)};
+      cur.pos = pos;
+      if (OperandCount(cur.op) > 0) cur.first = code_.operand(pos + 1);
+      if (OperandCount(cur.op) > 1) cur.second = code_.operand(pos + 5);
+      instrs_.push_back(cur);
+      pos += 1 + 4 * OperandCount(cur.op);
+    }
+  }
+
+  /*!
+   * @brief  ,      
+   */
+  void MarkTargets() {
+    std::set<size_t> targets = {static_cast<size_t>(entry_)};
+    for (const FunctionInfo& func : funcs_) targets.insert(func.poliz_start());
+    for (const Instr& cur : instrs_) {
+      if (IsJump(cur.op)) targets.insert(cur.first);
+    }
+    for (Instr& cur : instrs_) cur.target = targets.count(cur.pos) > 0;
+  }
+
+  /*!
+   * @brief        
+   */
+  void Encode() {
+    std::map<size_t, size_t> moved;  //   -> 
+    size_t pos = 0;
+    for (const Instr& cur : instrs_) {
+      moved[cur.pos] = pos;
+      pos += 1 + 4 * OperandCount(cur.op);
+    }
+    moved[code_.size()] = pos;
+
+    Bytecode res;
+    res.strings() = std::move(code_.strings());
+    for (const VarData& data : consts_) res.AddConst(data);
+    for (const Instr& cur : instrs_) {
+      if (IsJump(cur.op)) {
+        res.Emit(cur.op, moved.at(cur.first));
+      } else if (OperandCount(cur.op) == 2) {
+        res.Emit(cur.op, cur.first, cur.second);
+      } else if (OperandCount(cur.op) == 1) {
+        res.Emit(cur.op, cur.first);
+      } else {
+        res.Emit(cur.op);
+      }
+    }
+    for (FunctionInfo& func : funcs_) {
+      func.set_poliz_start(moved.at(func.poliz_start()));
+    }
+    entry_ = moved.at(entry_);
+    code_ = std::move(res);
+  }
+
+  /*!
+   * @brief     
+   * @return  
+   */
+  uint32_t AddConst(const VarData& data) {
+    consts_.push_back(data);
+    return static_cast<uint32_t>(consts_.size() - 1);
+  }
+
+  /*!
+   * @brief    ,   
+   *
+   *         ,   
+   *        
+   */
+  void Fold() {
+    for (size_t size = 0; size != instrs_.size();) {
+      size = instrs_.size();
+      MarkTargets();
+      FoldOnce();
+    }
+  }
+
+  /*!
+   * @brief     
+   */
+  void FoldOnce() {
+    std::vector<Instr> res;
+    res.reserve(instrs_.size());
+    size_t consts = 0;  //      res
+    for (const Instr& cur : instrs_) {
+      if (cur.target) consts = 0;
+      if (cur.op == OpCodes::Const) {
+        res.push_back(cur);
+        ++consts;
+      } else if (!FoldInto(res, consts, cur)) {
+        res.push_back(cur);
+        consts = 0;
+      }
+    }
+    instrs_ = std::move(res);
+  }
+
+  /*!
+   * @brief       
+   * @param res ,     
+   * @param consts      ,    
+   * @param cur 
+   * @return true,        
+   */
+  bool FoldInto(std::vector<Instr>& res, size_t& consts, const Instr& cur) {
+    if (cur.op == OpCodes::ToFloat) {
+      if (cur.first >= consts) return false;
+      Instr& arg = res[res.size() - 1 - cur.first];
+      const VarData& data = consts_[arg.first];
+      if (data.type_ != Int) return false;
+      arg.first = AddConst(VarData(static_cast<float>(data.int_)));
+      return true;
+    }
+    if (cur.op == OpCodes::Cast) {
+      if (consts < 1) return false;
+      VarData data(static_cast<VarTypes>(cur.first));
+      data.Assign(consts_[res.back().first], code_.strings());
+      res.back().first = AddConst(data);
+      return true;
+    }
+    if (cur.op == OpCodes::JumpFalse || cur.op == OpCodes::AndJump ||
+        cur.op == OpCodes::OrJump) {
+      return FoldJump(res, consts, cur);
+    }
+    VarData data(Int);
+    if (cur.op == OpCodes::PostNot) {
+      if (consts < 1 || consts_[res.back().first].type_ == String) {
+        return false;
+      }
+      try {
+        data = consts_[res.back().first].Factorial();
+      } catch (std::invalid_argument&) {
+        return false;
+      }
+      res.back().first = AddConst(data);
+      return true;
+    }
+    if (consts < 2 || !Evaluate(cur.op, consts_[res[res.size() - 2].first],
+                                consts_[res.back().first], data)) {
+      return false;
+    }
+    res.pop_back();
+    res.back().first = AddConst(data);
+    --consts;
+    return true;
+  }
+
+  /*!
+   * @brief         
+   * @param res ,     
+   * @param consts      
+   * @param cur  JumpFalse, AndJump  OrJump
+   * @return true,     
+   */
+  bool FoldJump(std::vector<Instr>& res, size_t& consts, const Instr& cur) {
+    if (consts < 1) return false;
+    Instr& cond = res.back();
+    bool jumps;
+    try {
+      VarData cond_false =
+          consts_[cond.first].Equal(VarData(false), code_.strings());
+      jumps = cond_false.bool_ != (cur.op == OpCodes::OrJump);
+    } catch (std::invalid_argument&) {
+      return false;
+    }
+    if (!jumps) {
+      //    ,    
+      if (cond.target) return false;
+      res.pop_back();
+      --consts;
+    } else if (cur.op == OpCodes::JumpFalse) {
+      cond.op = OpCodes::Jump;
+      cond.first = cur.first;
+      consts = 0;
+    } else {
+      cond.first = AddConst(VarData(cur.op == OpCodes::OrJump));
+      Instr jump = cur;
+      jump.op = OpCodes::Jump;
+      res.push_back(jump);
+      consts = 0;
+    }
+    return true;
+  }
+
+  /*!
+   * @brief      int
+   */
+  static int IntValue(const VarData& data) {
+    return data.type_ == Char ? data.char_
+           : data.type_ == Bool ? data.bool_
+                                : data.int_;
+  }
+
+  /*!
+   * @brief     
+   * @param op 
+   * @param lhs  
+   * @param rhs  
+   * @param res ,       
+   * @return true,      
+   */
+  bool Evaluate(OpCodes op, VarData lhs, VarData rhs, VarData& res) {
+    StringHeap& strings = code_.strings();
+    OpCodes generic = GenericOpCode(op);
+    if (generic != op) {
+      //     ,    , 
+      // ,      
+      VarTypes type = op == OpCodes::Concat           ? String
+                      : op < OpCodes::AddFloat ? Int
+                                                      : Float;
+      if (lhs.type_ != type || rhs.type_ != type) return false;
+    }
+    bool ints = lhs.type_ != Float && rhs.type_ != Float &&
+                lhs.type_ != String && rhs.type_ != String;
+    if (ints && (generic == OpCodes::Div || generic == OpCodes::Mod) &&
+        (IntValue(rhs) == 0 || IntValue(rhs) == -1)) {
+      return false;
+    }
+    if (ints && generic == OpCodes::Pow &&
+        (IntValue(rhs) < 0 || IntValue(rhs) > 64)) {
+      return false;
+    }
+    try {
+      switch (generic) {
+        case OpCodes::Pow:
+          res = lhs.Apply(DataPow, rhs, strings);
+          return true;
+        case OpCodes::Mul:
+          res = lhs.Apply(DataMul, rhs, strings);
+          return true;
+        case OpCodes::Div:
+          res = lhs.Apply(DataDiv, rhs, strings);
+          return true;
+        case OpCodes::Mod:
+          res = lhs.Apply(DataMod, rhs, strings);
+          return true;
+        case OpCodes::Add:
+          res = lhs.Apply(DataAdd, rhs, strings);
+          return true;
+        case OpCodes::Sub:
+          res = lhs.Apply(DataSub, rhs, strings);
+          return true;
+        case OpCodes::Less:
+          res = lhs.Less(rhs, strings);
+          return true;
+        case OpCodes::LessEq:
+          res = lhs.LessEq(rhs, strings);
+          return true;
+        case OpCodes::Greater:
+          res = lhs.Greater(rhs, strings);
+          return true;
+        case OpCodes::GreaterEq:
+          res = lhs.GreaterEq(rhs, strings);
+          return true;
+        case OpCodes::Eq:
+          res = lhs.Equal(rhs, strings);
+          return true;
+        case OpCodes::Ne:
+          res = lhs.NotEqual(rhs, strings);
+          return true;
+        case OpCodes::And:
+          res = lhs.Apply(DataAnd, rhs, strings);
+          return true;
+        case OpCodes::Or:
+          res = lhs.Apply(DataOr, rhs, strings);
+          return true;
+        default:
+          return false;
+      }
+    } catch (std::invalid_argument&) {
+      return false;
+    }
+  }
+
+  /*!
+   * @brief     ,    
+   *
+   *        ,   
+   * ,  , ,     .
+   *          ,   
+   *           
+   * 
+   * @return   
+   */
+  size_t Propagate() {
+    //         
+    std::vector<int> writes(globals_.size(), 0);
+    std::vector<size_t> written_at(globals_.size(), 0);
+    std::map<size_t, size_t> index;  //   ->  
+    for (size_t i = 0; i < instrs_.size(); ++i) {
+      if (instrs_[i].target) index[instrs_[i].pos] = i;
+    }
+    std::set<size_t> starts = {static_cast<size_t>(entry_)};
+    for (const FunctionInfo& func : funcs_) starts.insert(func.poliz_start());
+    auto main = index.find(entry_);
+    std::set<size_t> loops;  // ,     
+    for (size_t i = 0; i < instrs_.size(); ++i) {
+      const Instr& cur = instrs_[i];
+      if (IsJump(cur.op) && index.count(cur.first) &&
+          index[cur.first] <= i) {
+        loops.insert(index[cur.first]);
+      }
+    }
+
+    auto escape = [&](const State& state) {
+      for (const Entry& entry : state.stack) {
+        if (entry.slot >= 0) writes[entry.slot] += 2;
+      }
+    };
+    std::map<size_t, std::vector<State>> incoming;  //   
+    State state;
+    bool live = true;  //       
+    auto pop = [&state]() {
+      if (state.stack.empty()) return Entry();
+      Entry res = state.stack.back();
+      state.stack.pop_back();
+      return res;
+    };
+    auto write = [&](size_t i) {
+      if (state.stack.empty()) return;
+      int slot = state.stack.back().slot;
+      if (slot >= 0) ++writes[slot], written_at[slot] = i;
+    };
+    auto jump = [&](size_t i, uint32_t address) {
+      auto found = index.find(address);
+      if (found == index.end()) return;
+      if (found->second <= i) {
+        escape(state);
+      } else {
+        incoming[found->second].push_back(state);
+      }
+    };
+
+    for (size_t i = 0; i < instrs_.size(); ++i) {
+      const Instr& cur = instrs_[i];
+      if (cur.target) {
+        std::vector<State> in = std::move(incoming[i]);
+        if (live) in.push_back(state);
+        if (starts.count(cur.pos)) in.push_back(State());
+        bool same = !loops.count(i) && !in.empty();
+        for (const State& other : in) {
+          same = same && other.unknown == in[0].unknown &&
+                 other.stack.size() == in[0].stack.size();
+          for (size_t k = 0; same && k < other.stack.size(); ++k) {
+            same = other.stack[k].slot == in[0].stack[k].slot;
+          }
+        }
+        if (same) {
+          state = in[0];
+          for (const State& other : in) {
+            for (size_t k = 0; k < other.stack.size(); ++k) {
+              if (other.stack[k].producer != state.stack[k].producer) {
+                state.stack[k].producer = -1;
+              }
+            }
+          }
+        } else {
+          for (const State& other : in) escape(other);
+          state = State();
+          state.unknown = true;
+        }
+      } else if (!live) {
+        state = State();
+        state.unknown = true;
+      }
+      live = true;
+
+      int producer = static_cast<int>(i);
+      switch (cur.op) {
+        case OpCodes::Nop:
+        case OpCodes::Comma:
+          break;
+        case OpCodes::Var:
+          state.stack.push_back(
+              {cur.first < globals_.size() && globals_[cur.first].size_ == 0
+                   ? static_cast<int>(cur.first)
+                   : -1,
+               producer});
+          break;
+        case OpCodes::Local:
+        case OpCodes::Const:
+          state.stack.push_back({-1, producer});
+          break;
+        case OpCodes::Jump:
+          jump(i, cur.first);
+          live = false;
+          break;
+        case OpCodes::JumpFalse:
+          pop();
+          jump(i, cur.first);
+          break;
+        case OpCodes::AndJump:
+        case OpCodes::OrJump:
+          //       
+          pop();
+          state.stack.push_back({-1, producer});
+          jump(i, cur.first);
+          state.stack.pop_back();
+          break;
+        case OpCodes::Call:
+          for (uint32_t k = 0; k < cur.first; ++k) pop();
+          state.stack.push_back({-1, producer});
+          break;
+        case OpCodes::Return:
+          //    ,     
+          // . main  ,     
+          pop();
+          if (main == index.end() || i < main->second) escape(state);
+          live = false;
+          break;
+        case OpCodes::In:
+        case OpCodes::Out: {
+          Entry count = pop();
+          if (count.producer < 0 ||
+              instrs_[count.producer].op != OpCodes::Const ||
+              consts_[instrs_[count.producer].first].type_ != Int) {
+            return 0;
+          }
+          for (int k = consts_[instrs_[count.producer].first].int_; k > 0;
+               --k) {
+            if (cur.op == OpCodes::In) write(i);
+            pop();
+          }
+          break;
+        }
+        case OpCodes::PostInc:
+        case OpCodes::PostDec:
+          write(i);
+          state.stack.push_back({-1, producer});
+          break;
+        case OpCodes::PreInc:
+        case OpCodes::PreDec:
+          write(i);
+          state.stack.push_back(state.stack.empty() ? Entry()
+                                                    : state.stack.back());
+          break;
+        case OpCodes::PostNot:
+          pop();
+          state.stack.push_back({-1, producer});
+          break;
+        case OpCodes::Index:
+        case OpCodes::PreNot:
+        case OpCodes::UnPlus:
+        case OpCodes::UnMinus:
+          if (cur.op == OpCodes::Index) pop();
+          state.stack.push_back({-1, producer});
+          break;
+        case OpCodes::Pop:
+          state = State();
+          break;
+        case OpCodes::ToFloat:
+          if (cur.first < state.stack.size()) {
+            state.stack[state.stack.size() - 1 - cur.first] = {-1, producer};
+          }
+          break;
+        case OpCodes::Cast:
+          pop();
+          state.stack.push_back({-1, producer});
+          break;
+        default:
+          if (IsAssign(cur.op)) {
+            pop();
+            write(i);
+            state.stack.push_back(state.stack.empty() ? Entry()
+                                                      : state.stack.back());
+          } else {
+            pop();
+            pop();
+            state.stack.push_back({-1, producer});
+          }
+          break;
+      }
+    }
+
+    // ,  main   :    
+    //   
+    size_t begin = main == index.end() || loops.count(main->second)
+                       ? instrs_.size()
+                       : main->second;
+    size_t end = begin;
+    while (end < instrs_.size() && (end == begin || !instrs_[end].target) &&
+           instrs_[end].op != OpCodes::Call && !IsJump(instrs_[end].op) &&
+           instrs_[end].op != OpCodes::Return) {
+      ++end;
+    }
+
+    size_t replaced = 0;
+    for (size_t slot = 0; slot < writes.size(); ++slot) {
+      size_t at = written_at[slot];
+      if (writes[slot] != 1 || at < begin + 2 || at >= end) continue;
+      OpCodes op = instrs_[at].op;
+      const Instr& var = instrs_[at - 2];
+      if ((op != OpCodes::Assign && op != OpCodes::AssignInt &&
+           op != OpCodes::AssignFloat) ||
+          instrs_[at - 1].op != OpCodes::Const || var.op != OpCodes::Var ||
+          var.first != slot) {
+        continue;
+      }
+      bool read_before = false;
+      for (size_t i = begin; i < at - 2; ++i) {
+        read_before = read_before || (instrs_[i].op == OpCodes::Var &&
+                                      instrs_[i].first == slot);
+      }
+      if (read_before) continue;
+
+      VarData data = globals_[slot].data_;
+      data.Assign(consts_[instrs_[at - 1].first], code_.strings());
+      uint32_t value = AddConst(data);
+      for (size_t i = 0; i < instrs_.size(); ++i) {
+        if (i != at - 2 && instrs_[i].op == OpCodes::Var &&
+            instrs_[i].first == slot) {
+          instrs_[i].op = OpCodes::Const;
+          instrs_[i].first = value;
+          ++replaced;
+        }
+      }
+    }
+    return replaced;
+  }
+
+  /*!
+   * @brief    ,  
+   */
+  static bool IsAssign(OpCodes op) {
+    switch (GenericOpCode(op)) {
+      case OpCodes::Assign:
+      case OpCodes::AddAssign:
+      case OpCodes::SubAssign:
+      case OpCodes::MulAssign:
+      case OpCodes::DivAssign:
+      case OpCodes::ModAssign:
+        return true;
+      default:
+        return false;
+    }
+  }
+};
@@ -1,6 +1,14 @@
 #pragma once
+#include <algorithm>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <array>
+#include <deque>
+#include <utility>
+#include <cstdint>
+#include <type_traits>
+#include <unordered_map>
 #include <stdexcept>
 #include <cmath>
 #include <math.h>
@@ -11,17 +19,6 @@
  * @brief          
 */
 
-/*!
- * @brief   
-*/
-enum PolizElemTypes {
-  Variable = 0, ///<  
-  Oper = 1, ///< 
-  Address = 2, ///<  ()  
-  Lit = 3, ///< 
-  Func = 4 ///<   
-};
-
 /*!
  * @brief  
 */
@@ -33,6 +30,26 @@ enum VarTypes {
   String = 4 ///<  
 };
 
+//!   
+constexpr int kVarTypesCount = 5;
+
+/*!
+ * @brief    ,     DataKernel
+*/
+enum DataOpers {
+  DataAdd, ///< +
+  DataSub, ///< -
+  DataMul, ///< *
+  DataDiv, ///< /
+  DataMod, ///< %
+  DataPow, ///< **
+  DataLess, ///< <
+  DataAnd, ///< &&
+  DataOr, ///< ||
+  DataAssign, ///<       
+  DataOpersCount
+};
+
 /*!
  * @brief    VarTypes  std::string
  * @param type  ,     
@@ -63,371 +80,235 @@ VarTypes ToVarType(std::string type) {
 }
 
 /*!
- * @brief    
- *        ,       
+ * @brief  ,      
+ *   VarData      ,     -   .
+ *
+ *   -  (Bytecode),      ,               .         .
+ *
+ * - ( )   Intern:         . ,    (, ,   ),   Make    .     ,   :     (CollectDue),           Mark,  Sweep      .          
 */
-class PolizElem {
+class StringHeap {
  public:
   /*!
-   * @brief     
-   * @param type   
+   * @brief  ,      
+   *     0,      
   */
-  PolizElem(PolizElemTypes type) : type_(type) {}
+  StringHeap() { Intern(""); }
+  // ids_    strings_,    
+  StringHeap(const StringHeap&) = delete;
+  StringHeap& operator=(const StringHeap&) = delete;
+  StringHeap(StringHeap&&) = default;
+  StringHeap& operator=(StringHeap&&) = default;
   /*!
-   * @brief   type_
-   * @return   type_
+   * @brief  -  ,     
+   * @param str 
+   * @return  
   */
-  PolizElemTypes type() const { return type_; }
-
+  uint32_t Intern(std::string_view str) {
+    auto found = ids_.find(str);
+    if (found != ids_.end()) return found->second;
+    strings_.emplace_back(str);
+    states_.push_back(Permanent);
+    uint32_t id = static_cast<uint32_t>(strings_.size() - 1);
+    ids_.emplace(strings_.back(), id);
+    return id;
+  }
   /*!
-   * @brief  ,    
+   * @brief  ,   
+   *     ,     -   
+   * @param str 
+   * @return  
   */
-  virtual ~PolizElem() {}
- private:
-  PolizElemTypes type_; ///<   
-};
-
-/*!
- * @brief    - 
-*/
-class PolizOper :  public PolizElem {
- public:
+  uint32_t Make(std::string str) {
+    ++made_;
+    ++live_;
+    if (free_.empty()) {
+      strings_.push_back(std::move(str));
+      states_.push_back(Live);
+      return static_cast<uint32_t>(strings_.size() - 1);
+    }
+    uint32_t id = free_.back();
+    free_.pop_back();
+    strings_[id] = std::move(str);
+    states_[id] = Live;
+    return id;
+  }
   /*!
-   * @brief      
-   * @param oper ,     
+   * @brief   
+   * @param id  
+   * @return ,         
   */
-  PolizOper(std::string oper)
-      : PolizElem(Oper), oper_(oper) {}
+  const std::string& Get(uint32_t id) const { return strings_[id]; }
   /*!
-   * @brief   oper_
-   * @return   oper_
+   * @brief    ,  
   */
-  std::string oper() const { return oper_; }
- private:
-  std::string oper_; ///<   
-};
+  size_t size() const { return strings_.size(); }
 
-/*!
- * @brief    - 
- *      ,    . .      ,     .      
-*/
-class PolizAddress :  public PolizElem {
- public:
   /*!
-   * @brief   ()    
-   * @param address   ,     
+   * @brief      
+   *   : ,      ,    ,     
   */
-  PolizAddress(int address)
-      : PolizElem(Address), address_(address) {}
+  void Seal() {
+    for (uint8_t& state : states_) {
+      if (state == Live) state = Permanent;
+    }
+    live_ = 0;
+    made_ = 0;
+  }
   /*!
-   * @brief   address_
-   * @return   address_
+   * @brief     
+   * @return true,        ,   ,    kCollectMin
   */
-  int address() const { return address_; }
-
- private:
-  int address_; ///<  ()  
-};
-
-struct Var;
-
-/*!
- * @brief    -  
- *          ,      
-*/
-class PolizVar :  public PolizElem {
- public:
+  bool CollectDue() const { return made_ >= budget_; }
   /*!
-   * @brief       
-   * @param var  ,     
+   * @brief       
+   * @param id  
   */
-  PolizVar(Var* var) : PolizElem(Variable),var_(var){}
+  void Mark(uint32_t id) {
+    if (states_[id] == Live) states_[id] = Marked;
+  }
   /*!
-   * @brief   var_
-   * @return   var_
+   * @brief       ,    
   */
-  Var* var() const { return var_; }
+  void Sweep() {
+    for (uint32_t id = 0; id < states_.size(); ++id) {
+      if (states_[id] == Marked) {
+        states_[id] = Live;
+      } else if (states_[id] == Live) {
+        states_[id] = Free;
+        strings_[id].clear();
+        free_.push_back(id);
+        --live_;
+      }
+    }
+    made_ = 0;
+    budget_ = std::max(kCollectMin, live_);
+  }
+
  private:
-  Var* var_; ///<  ,    
+  /*!
+   * @brief    
+  */
+  enum States : uint8_t {
+    Permanent, ///< ,  
+    Live, ///<  
+    Marked, ///<  ,   
+    Free ///<  
+  };
+  //!        
+  static constexpr size_t kCollectMin = 4096;
+
+  std::deque<std::string> strings_; ///< .  std::deque      
+  std::vector<uint8_t> states_; ///<   
+  std::vector<uint32_t> free_; ///<   
+  std::unordered_map<std::string_view, uint32_t> ids_; ///<  -
+  size_t live_ = 0; ///<   ,     
+  size_t made_ = 0; ///<       
+  size_t budget_ = kCollectMin; ///<        
 };
 
 /*!
  * @brief  ,     ,    
  *    ,    .          ,        .
+ *
+ *  -        ,     StringHeap.   8    .        Assign
 */
 struct VarData {
   /*!
    * @brief    ,    
+   *   : 0, false,  ,    - '0'
    * @param type  
   */
-  VarData(VarTypes type) : type_(type) {}
+  VarData(VarTypes type) : type_(type) {
+    if (type == Char) {
+      char_ = '0';
+    } else if (type == Float) {
+      float_ = 0.f;
+    } else {
+      int_ = 0;
+    }
+  }
   /*!
    * @brief     
    * @param val  ,    
   */
-  VarData(int val) : type_(Int), int_(val) {}
+  VarData(int val) : int_(val), type_(Int) {}
   /*!
    * @brief     
    * @param val  ,    
   */
-  VarData(char val) : type_(Char), char_(val) {}
+  VarData(char val) : char_(val), type_(Char) {}
   /*!
    * @brief     
    * @param val  ,    
    */
-  VarData(float val) : type_(Float), float_(val) {}
+  VarData(float val) : float_(val), type_(Float) {}
   /*!
    * @brief     
    * @param val  ,    
    */
-  VarData(bool val) : type_(Bool), bool_(val) {}
+  VarData(bool val) : bool_(val), type_(Bool) {}
   /*!
-   * @brief     
+   * @brief    ,   
+   * @param strings   
    * @param val  ,    
    */
-  VarData(std::string val) : type_(String), string_(val) {}
+  VarData(StringHeap& strings, std::string val)
+      : string_(strings.Make(std::move(val))), type_(String) {}
+  /*!
+   * @brief   
+   * @param strings   
+   * @param val  
+   * @return   ,  ,   
+  */
+  static VarData Constant(StringHeap& strings, std::string_view val) {
+    VarData res(String);
+    res.string_ = strings.Intern(val);
+    return res;
+  }
 
-  int int_ = 0; ///<  ,     ,    
-  bool bool_ = false; ///<  ,     ,    
-  std::string string_ = ""; ///<  ,     ,    
-  char char_ = '0'; ///<  ,     ,    
-  float float_ = 0.f; ///<  ,     ,    
+  /*!
+   * @brief  
+   * @param strings   ,    
+   * @return    
+  */
+  const std::string& str(const StringHeap& strings) const {
+    return strings.Get(string_);
+  }
+
+  union {
+    int int_; ///<  ,     ,    
+    bool bool_; ///<  ,     ,    
+    char char_; ///<  ,     ,    
+    float float_; ///<  ,     ,    
+    uint32_t string_; ///<    StringHeap,    
+  };
   VarTypes type_; ///<  ,    .            -  ,   . .
 
-  VarData operator+(VarData rhs) {
-    if (type_ == Int) {
-      if (rhs.type_ == Int) {
-        return VarData(int_ + rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(int_ + rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(int_ + rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(int_ + rhs.float_);
-      } else if (rhs.type_ == String) {
-        return VarData((char)int_ + rhs.string_);
-      }
-    } else if (type_ == Bool) {
-      if (rhs.type_ == Int) {
-        return VarData(bool_ + rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(bool_ + rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(bool_ + rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(bool_ + rhs.float_);
-      } else if (rhs.type_ == String) {
-        return VarData((char)bool_ + rhs.string_);
-      }
-    } else if (type_ == Char) {
-      if (rhs.type_ == Int) {
-        return VarData(char_ + rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(char_ + rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(char_ + rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(char_ + rhs.float_);
-      } else if (rhs.type_ == String) {
-        return VarData(char_ + rhs.string_);
-      }
-    } else if (type_ == Float) {
-      if (rhs.type_ == Int) {
-        return VarData(float_ + rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(float_ + rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(float_ + rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(float_ + rhs.float_);
-      } else if (rhs.type_ == String) {
-        return VarData((char)(int)float_ + rhs.string_);
-      }
-    } else if (type_ == String) {
-      if (rhs.type_ == Int) {
-        return VarData(string_ + (char)rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(string_ + (char)rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(string_ + rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(string_ + (char)rhs.float_);
-      } else if (rhs.type_ == String) {
-        return VarData(string_ + rhs.string_);
-      }
-    }
+  /*!
+   * @brief  
+   *      DataLess
+   * @param rhs  
+   * @param strings   
+   * @return  , bool
+  */
+  VarData Less(VarData rhs, StringHeap& strings) const {
+    return Apply(DataLess, rhs, strings);
   }
-  VarData operator-(VarData rhs) {
-    if (type_ == Int) {
-      if (rhs.type_ == Int) {
-        return VarData(int_ - rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(int_ - rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(int_ - rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(int_ - rhs.float_);
-      }
-    } else if (type_ == Bool) {
-      if (rhs.type_ == Int) {
-        return VarData(bool_ - rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(bool_ - rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(bool_ - rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(bool_ - rhs.float_);
-      }
-    } else if (type_ == Char) {
-      if (rhs.type_ == Int) {
-        return VarData(char_ - rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(char_ - rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(char_ - rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(char_ - rhs.float_);
-      }
-    } else if (type_ == Float) {
-      if (rhs.type_ == Int) {
-        return VarData(float_ - rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(float_ - rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(float_ - rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(float_ - rhs.float_);
-      }
-    }
+  VarData Greater(VarData rhs, StringHeap& strings) const {
+    return rhs.Less(*this, strings);
   }
-  VarData operator*(VarData rhs) {
-    if (type_ == Int) {
-      if (rhs.type_ == Int) {
-        return VarData(int_ * rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(int_ * rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(int_ * rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(int_ * rhs.float_);
-      }
-    } else if (type_ == Bool) {
-      if (rhs.type_ == Int) {
-        return VarData(bool_ * rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(bool_ * rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(bool_ * rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(bool_ * rhs.float_);
-      }
-    } else if (type_ == Char) {
-      if (rhs.type_ == Int) {
-        return VarData(char_ * rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(char_ * rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(char_ * rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(char_ * rhs.float_);
-      }
-    } else if (type_ == Float) {
-      if (rhs.type_ == Int) {
-        return VarData(float_ * rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(float_ * rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(float_ * rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(float_ * rhs.float_);
-      }
-    }
+  VarData LessEq(VarData rhs, StringHeap& strings) const {
+    return VarData(!Greater(rhs, strings).bool_);
   }
-  VarData operator/(VarData rhs) {
-    if (type_ == Int) {
-      if (rhs.type_ == Int) {
-        return VarData(int_ / rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(int_ / rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(int_ / rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(int_ / rhs.float_);
-      }
-    } else if (type_ == Bool) {
-      if (rhs.type_ == Int) {
-        return VarData(bool_ / rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(bool_ / rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(bool_ / rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(bool_ / rhs.float_);
-      }
-    } else if (type_ == Char) {
-      if (rhs.type_ == Int) {
-        return VarData(char_ / rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(char_ / rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(char_ / rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(char_ / rhs.float_);
-      }
-    } else if (type_ == Float) {
-      if (rhs.type_ == Int) {
-        return VarData(float_ / rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(float_ / rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(float_ / rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(float_ / rhs.float_);
-      }
-    }
+  VarData GreaterEq(VarData rhs, StringHeap& strings) const {
+    return VarData(!Less(rhs, strings).bool_);
   }
-  VarData operator%(VarData rhs) {
-    if (type_ == Int) {
-      if (rhs.type_ == Int) {
-        return VarData(int_ % rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(int_ % rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(int_ % rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(std::fmodf(int_, rhs.float_));
-      }
-    } else if (type_ == Bool) {
-      if (rhs.type_ == Int) {
-        return VarData(bool_ % rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(bool_ % rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(bool_ % rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(std::fmodf(bool_, rhs.float_));
-      }
-    } else if (type_ == Char) {
-      if (rhs.type_ == Int) {
-        return VarData(char_ % rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(char_ % rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(char_ % rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(std::fmodf(char_, rhs.float_));
-      }
-    } else if (type_ == Float) {
-      if (rhs.type_ == Int) {
-        return VarData(std::fmodf(float_, rhs.int_));
-      } else if (rhs.type_ == Bool) {
-        return VarData(std::fmodf(float_, rhs.bool_));
-      } else if (rhs.type_ == Char) {
-        return VarData(std::fmodf(float_, rhs.char_));
-      } else if (rhs.type_ == Float) {
-        return VarData(std::fmodf(float_, rhs.float_));
-      }
-    }
+  VarData Equal(VarData rhs, StringHeap& strings) const {
+    return VarData(!Less(rhs, strings).bool_ && !Greater(rhs, strings).bool_);
+  }
+  VarData NotEqual(VarData rhs, StringHeap& strings) const {
+    return VarData(!Equal(rhs, strings).bool_);
   }
 
   /*!
@@ -457,12 +338,12 @@ struct VarData {
    * @brief      
    * @return          
   */
-  VarData UnPlus() { return *this; }
+  VarData UnPlus() const { return *this; }
   /*!
    * @brief      
    * @return          
    */
-  VarData UnMinus() {
+  VarData UnMinus() const {
     if (type_ == Int) {
       return VarData(-int_);
     } else if (type_ == Bool) {
@@ -477,7 +358,7 @@ struct VarData {
    * @brief     
    * @return         
    */
-  VarData Negation() {
+  VarData Negation() const {
     if (type_ == Int) {
       return VarData(!int_);
     } else if (type_ == Bool) {
@@ -495,300 +376,204 @@ struct VarData {
    * @param deg  
    * @return   
   */
-  int Power(int num, int deg) {
+  static int Power(int num, int deg) {
     if (deg == 0) return 1;
     if (deg % 2 == 0) return Power(num, deg / 2) * Power(num, deg / 2);
     return num * Power(num, deg - 1);
   }
   /*!
-   * @brief       
-   * @param rhs      
-   * @return ,         
+   * @brief        
+   *    :    .     ,       
+   * @param rhs  
+   * @param strings   
+   * @return    
   */
-  VarData Power(VarData rhs) {
-    if (type_ == Int) {
-      if (rhs.type_ == Int) {
-        return VarData(Power(int_, rhs.int_));
-      } else if (rhs.type_ == Bool) {
-        return VarData(Power(int_, rhs.bool_));
-      } else if (rhs.type_ == Char) {
-        return VarData(Power(int_, rhs.char_));
-      } else if (rhs.type_ == Float) {
-        return VarData(std::powf(int_, rhs.float_));
-      }
-    } else if (type_ == Bool) {
-      if (rhs.type_ == Int) {
-        return VarData(Power(bool_, rhs.int_));
-      } else if (rhs.type_ == Bool) {
-        return VarData(Power(bool_, rhs.bool_));
-      } else if (rhs.type_ == Char) {
-        return VarData(Power(bool_, rhs.char_));
-      } else if (rhs.type_ == Float) {
-        return VarData(std::powf(bool_, rhs.float_));
-      }
-    } else if (type_ == Char) {
-      if (rhs.type_ == Int) {
-        return VarData(Power(char_, rhs.int_));
-      } else if (rhs.type_ == Bool) {
-        return VarData(Power(char_, rhs.bool_));
-      } else if (rhs.type_ == Char) {
-        return VarData(Power(char_, rhs.char_));
-      } else if (rhs.type_ == Float) {
-        return VarData(std::powf(char_, rhs.float_));
-      }
-    } else if (type_ == Float) {
-      if (rhs.type_ == Int) {
-        return VarData(std::powf(float_, rhs.int_));
-      } else if (rhs.type_ == Bool) {
-        return VarData(std::powf(float_, rhs.bool_));
-      } else if (rhs.type_ == Char) {
-        return VarData(std::powf(float_, rhs.char_));
-      } else if (rhs.type_ == Float) {
-        return VarData(std::powf(float_, rhs.float_));
-      }
-    }
+  VarData& Assign(VarData rhs, StringHeap& strings) {
+    return *this = Apply(DataAssign, rhs, strings);
+  }
+  /*!
+   * @brief  ,  +=:         
+   * @param oper 
+   * @param rhs  
+   * @param strings   
+   * @return    
+  */
+  VarData& ApplyAssign(DataOpers oper, VarData rhs, StringHeap& strings) {
+    return Assign(Apply(oper, rhs, strings), strings);
   }
 
-  VarData operator<(VarData rhs) {
-    if (type_ == Int) {
-      if (rhs.type_ == Int) {
-        return VarData(int_ < rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(int_ < rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(int_ < rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(int_ < rhs.float_);
-      } else if (rhs.type_ == String) {
-        std::string tmp;
-        tmp += (char)int_;
-        return VarData(tmp < rhs.string_);
-      }
-    } else if (type_ == Bool) {
-      if (rhs.type_ == Int) {
-        return VarData(bool_ < rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(bool_ < rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(bool_ < rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(bool_ < rhs.float_);
-      } else if (rhs.type_ == String) {
-        std::string tmp;
-        tmp += (char)bool_;
-        return VarData(tmp < rhs.string_);
-      }
-    } else if (type_ == Char) {
-      if (rhs.type_ == Int) {
-        return VarData(char_ < rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(char_ < rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(char_ < rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(char_ < rhs.float_);
-      } else if (rhs.type_ == String) {
-        std::string tmp;
-        tmp += char_;
-        return VarData(tmp < rhs.string_);
-      }
-    } else if (type_ == Float) {
-      if (rhs.type_ == Int) {
-        return VarData(float_ < rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(float_ < rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(float_ < rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(float_ < rhs.float_);
-      } else if (rhs.type_ == String) {
-        std::string tmp;
-        tmp += (char)float_;
-        return VarData(tmp < rhs.string_);
-      }
-    } else if (type_ == String) {
-      if (rhs.type_ == Int) {
-        std::string tmp;
-        tmp += (char)rhs.int_;
-        return VarData(string_ < tmp);
-      } else if (rhs.type_ == Bool) {
-        std::string tmp;
-        tmp += (char)rhs.bool_;
-        return VarData(string_ < tmp);
-      } else if (rhs.type_ == Char) {
-        std::string tmp;
-        tmp += (char)rhs.char_;
-        return VarData(string_ < tmp);
-      } else if (rhs.type_ == Float) {
-        std::string tmp;
-        tmp += (char)(int)rhs.float_;
-        return VarData(string_ < tmp);
-      } else if (rhs.type_ == String) {
-        return VarData(string_ < rhs.string_);
-      }
-    }
+  /*!
+   * @brief   
+   *          DataKernel,  -      kDataKernels
+   * @param oper 
+   * @param rhs  
+   * @param strings   ,       
+   * @return  
+   * @throw std::invalid_argument       
+  */
+  VarData Apply(DataOpers oper, VarData rhs, StringHeap& strings) const;
+};
+
+static_assert(sizeof(VarData) <= 16, "VarData must stay compact");
+static_assert(std::is_trivially_copyable<VarData>::value,
+              "VarData must be copied bytewise");
+
+/*!
+ * @brief     
+ * @tparam type  
+*/
+template <VarTypes type>
+auto Field(const VarData& data) {
+  if constexpr (type == Int) {
+    return data.int_;
+  } else if constexpr (type == Char) {
+    return data.char_;
+  } else if constexpr (type == Float) {
+    return data.float_;
+  } else {
+    return data.bool_;
   }
-  VarData operator>=(VarData rhs) { return VarData(!((*this) < rhs).bool_); }
-  VarData operator>(VarData rhs) { return rhs < *this; }
-  VarData operator<=(VarData rhs) { return VarData(!((*this) > rhs).bool_); }
-  VarData operator==(VarData rhs) {
-    return VarData(!(*this < rhs).bool_ && !(*this > rhs).bool_);
+}
+
+/*!
+ * @brief         
+ * @tparam type  
+*/
+template <VarTypes type, class Value>
+void SetField(VarData& data, Value val) {
+  if constexpr (type == Int) {
+    data.int_ = val;
+  } else if constexpr (type == Char) {
+    data.char_ = val;
+  } else if constexpr (type == Float) {
+    data.float_ = val;
+  } else {
+    data.bool_ = val;
   }
-  VarData operator!=(VarData rhs) { return VarData(!(*this == rhs).bool_); }
-  VarData operator&&(VarData rhs) {
-    if (type_ == Int) {
-      if (rhs.type_ == Int) {
-        return VarData(int_ && rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(int_ && rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(int_ && rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(int_ && rhs.float_);
-      }
-    } else if (type_ == Bool) {
-      if (rhs.type_ == Int) {
-        return VarData(bool_ && rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(bool_ && rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(bool_ && rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(bool_ && rhs.float_);
-      }
-    } else if (type_ == Char) {
-      if (rhs.type_ == Int) {
-        return VarData(char_ && rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(char_ && rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(char_ && rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(char_ && rhs.float_);
-      }
-    } else if (type_ == Float) {
-      if (rhs.type_ == Int) {
-        return VarData(float_ && rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(float_ && rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(float_ && rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(float_ && rhs.float_);
-      }
-    }
+}
+
+/*!
+ * @brief    :   ,  -       
+ * @tparam type  
+*/
+template <VarTypes type>
+std::string StringOf(const StringHeap& strings, const VarData& data) {
+  if constexpr (type == String) {
+    return data.str(strings);
+  } else {
+    return std::string(1, static_cast<char>(static_cast<int>(Field<type>(data))));
   }
-  VarData operator||(VarData rhs) {
-    if (type_ == Int) {
-      if (rhs.type_ == Int) {
-        return VarData(int_ || rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(int_ || rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(int_ || rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(int_ || rhs.float_);
-      }
-    } else if (type_ == Bool) {
-      if (rhs.type_ == Int) {
-        return VarData(bool_ || rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(bool_ || rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(bool_ || rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(bool_ || rhs.float_);
-      }
-    } else if (type_ == Char) {
-      if (rhs.type_ == Int) {
-        return VarData(char_ || rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(char_ || rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(char_ || rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(char_ || rhs.float_);
-      }
-    } else if (type_ == Float) {
-      if (rhs.type_ == Int) {
-        return VarData(float_ || rhs.int_);
-      } else if (rhs.type_ == Bool) {
-        return VarData(float_ || rhs.bool_);
-      } else if (rhs.type_ == Char) {
-        return VarData(float_ || rhs.char_);
-      } else if (rhs.type_ == Float) {
-        return VarData(float_ || rhs.float_);
-      }
+}
+
+/*!
+ * @brief       
+ *
+ *      ,      C++: char  bool   int,      float -  float.     + ()  < ( ),        .     -   
+ * @tparam oper 
+ * @tparam lhs_type   
+ * @tparam rhs_type   
+*/
+template <DataOpers oper, VarTypes lhs_type, VarTypes rhs_type>
+VarData DataKernel(StringHeap& strings, VarData lhs, VarData rhs) {
+  constexpr bool kStrings = lhs_type == String || rhs_type == String;
+  constexpr bool kFloats = lhs_type == Float || rhs_type == Float;
+  if constexpr (oper == DataAssign) {
+    if constexpr (rhs_type == String) {
+      return lhs;
+    } else if constexpr (lhs_type == String) {
+      lhs.string_ = strings.Make(StringOf<rhs_type>(strings, rhs));
+      return lhs;
+    } else {
+      SetField<lhs_type>(lhs, Field<rhs_type>(rhs));
+      return lhs;
     }
-  }
-  VarData& operator=(VarData rhs) {
-    if (type_ == Int) {
-      if (rhs.type_ == Int) {
-        int_ = rhs.int_;
-      } else if (rhs.type_ == Bool) {
-        int_ = rhs.bool_;
-      } else if (rhs.type_ == Char) {
-        int_ = rhs.char_;
-      } else if (rhs.type_ == Float) {
-        int_ = rhs.float_;
-      }
-    } else if (type_ == Bool) {
-      if (rhs.type_ == Int) {
-        bool_ = rhs.int_;
-      } else if (rhs.type_ == Bool) {
-        bool_ = rhs.bool_;
-      } else if (rhs.type_ == Char) {
-        bool_ = rhs.char_;
-      } else if (rhs.type_ == Float) {
-        bool_ = rhs.float_;
-      }
-    } else if (type_ == Char) {
-      if (rhs.type_ == Int) {
-        char_ = rhs.int_;
-      } else if (rhs.type_ == Bool) {
-        char_ = rhs.bool_;
-      } else if (rhs.type_ == Char) {
-        char_ = rhs.char_;
-      } else if (rhs.type_ == Float) {
-        char_ = rhs.float_;
-      }
-    } else if (type_ == Float) {
-      if (rhs.type_ == Int) {
-        float_ = rhs.int_;
-      } else if (rhs.type_ == Bool) {
-        float_ = rhs.bool_;
-      } else if (rhs.type_ == Char) {
-        float_ = rhs.char_;
-      } else if (rhs.type_ == Float) {
-        float_ = rhs.float_;
-      }
-    } else if (type_ == String) {
-      if (rhs.type_ == Int) {
-        string_ = rhs.int_;
-      } else if (rhs.type_ == Bool) {
-        string_ = rhs.bool_;
-      } else if (rhs.type_ == Char) {
-        string_ = rhs.char_;
-      } else if (rhs.type_ == Float) {
-        string_ = rhs.float_;
-      }
+  } else if constexpr (kStrings) {
+    if constexpr (oper == DataAdd) {
+      return VarData(strings, StringOf<lhs_type>(strings, lhs) +
+                                  StringOf<rhs_type>(strings, rhs));
+    } else if constexpr (oper == DataLess) {
+      return VarData(StringOf<lhs_type>(strings, lhs) <
+                     StringOf<rhs_type>(strings, rhs));
+    } else {
+      throw std::invalid_argument("Operation is not defined for " +
+                                  ToString(lhs_type) + " and " +
+                                  ToString(rhs_type));
+    }
+  } else {
+    auto a = Field<lhs_type>(lhs);
+    auto b = Field<rhs_type>(rhs);
+    if constexpr (oper == DataAdd) {
+      return VarData(a + b);
+    } else if constexpr (oper == DataSub) {
+      return VarData(a - b);
+    } else if constexpr (oper == DataMul) {
+      return VarData(a * b);
+    } else if constexpr (oper == DataDiv) {
+      return VarData(a / b);
+    } else if constexpr (oper == DataMod) {
+      if constexpr (kFloats) {
+        return VarData(
+            std::fmod(static_cast<float>(a), static_cast<float>(b)));
+      } else {
+        return VarData(a % b);
+      }
+    } else if constexpr (oper == DataPow) {
+      if constexpr (kFloats) {
+        return VarData(
+            std::pow(static_cast<float>(a), static_cast<float>(b)));
+      } else {
+        return VarData(VarData::Power(a, b));
+      }
+    } else if constexpr (oper == DataLess) {
+      return VarData(a < b);
+    } else if constexpr (oper == DataAnd) {
+      return VarData(a && b);
+    } else {
+      return VarData(a || b);
     }
-    return *this;
   }
-  VarData& operator+=(VarData rhs) { return *this = *this + rhs; }
-  VarData& operator-=(VarData rhs) { return *this = *this - rhs; }
-  VarData& operator*=(VarData rhs) { return *this = *this * rhs; }
-  VarData& operator/=(VarData rhs) { return *this = *this / rhs; }
-  VarData& operator%=(VarData rhs) { return *this = *this % rhs; }
-};
+}
+
+//!      
+using DataKernelFn = VarData (*)(StringHeap&, VarData, VarData);
+
+template <DataOpers oper, size_t... pairs>
+constexpr std::array<DataKernelFn, sizeof...(pairs)> MakeDataKernelRow(
+    std::index_sequence<pairs...>) {
+  return {&DataKernel<oper, static_cast<VarTypes>(pairs / kVarTypesCount),
+                      static_cast<VarTypes>(pairs % kVarTypesCount)>...};
+}
+
+template <size_t... opers>
+constexpr std::array<std::array<DataKernelFn, kVarTypesCount * kVarTypesCount>,
+                     DataOpersCount>
+MakeDataKernels(std::index_sequence<opers...>) {
+  return {MakeDataKernelRow<static_cast<DataOpers>(opers)>(
+      std::make_index_sequence<kVarTypesCount * kVarTypesCount>())...};
+}
 
 /*!
- * @brief   <<,       VarData  
+ * @brief   : [][   * kVarTypesCount +  ]
+ *      DataKernel,        
+*/
+inline constexpr auto kDataKernels =
+    MakeDataKernels(std::make_index_sequence<DataOpersCount>());
+
+inline VarData VarData::Apply(DataOpers oper, VarData rhs,
+                              StringHeap& strings) const {
+  return kDataKernels[oper][type_ * kVarTypesCount + rhs.type_](strings, *this,
+                                                                rhs);
+}
+
+/*!
+ * @brief   VarData  
  * @param os  
  * @param data ,     
+ * @param strings   
  * @return     
 */
-std::ostream& operator<<(std::ostream& os, VarData const& data) {
+std::ostream& Print(std::ostream& os, VarData const& data,
+                    const StringHeap& strings) {
   if (data.type_ == Int) {
     return os << data.int_;
   } else if (data.type_ == Float) {
@@ -798,18 +583,18 @@ std::ostream& operator<<(std::ostream& os, VarData const& data) {
   } else if (data.type_ == Char) {
     return os << data.char_;
   } else {
-    return os << data.string_;
+    return os << data.str(strings);
   }
 }
 
 /*!
- * @brief   <<,      
- * VarData
+ * @brief   VarData  ,    
  * @param is  
  * @param data ,    
+ * @param strings   ,     
  * @return     
  */
-std::istream& operator>>(std::istream& is, VarData& data) {
+std::istream& Read(std::istream& is, VarData& data, StringHeap& strings) {
   if (data.type_ == Int) {
     return is >> data.int_;
   } else if (data.type_ == Float) {
@@ -819,61 +604,16 @@ std::istream& operator>>(std::istream& is, VarData& data) {
   } else if (data.type_ == Char) {
     return is >> data.char_;
   } else {
-    return is >> data.string_;
+    std::string str;
+    is >> str;
+    data.string_ = strings.Make(std::move(str));
+    return is;
   }
 }
 
-/*!
- * @brief    - 
- *      rvalue   
-*/
-class PolizLit : public PolizElem {
- public:
-  /*!
-   * @brief      
-   * @param type   
-  */
-  PolizLit(VarTypes type) : PolizElem(Lit), data_(type) {}
-  /*!
-   * @brief    ,    
-   * @param data ,     
-  */
-  PolizLit(VarData data) : PolizElem(Lit), data_(data) {}
-  VarData data_; ///<  
-
- private:
-};
-
-/*!
- * @brief    -   
-*/
-class PolizFuncCall : public PolizElem {
- public:
-  /*!
-   * @brief      -     
-   * @param args -  
-   * @param func   
-  */
-  PolizFuncCall(int args, std::string func)
-      : PolizElem(Func), arguments_(args), func_name_(func) {}
-  /*!
-   * @brief   arguments_
-   * @return   arguments_
-  */
-  int arguments() const { return arguments_; }
-  /*!
-   * @brief   func_name_
-   * @return   func_name_
-  */
-  std::string func_name() const { return func_name_; }
-
- private:
-  int arguments_; ///< -    
-  std::string func_name_; ///<   
-};
-
 /*!
  * @brief  ,     
+ *  -      ,          
 */
 struct Var {
   /*!
@@ -881,20 +621,14 @@ struct Var {
    * @param type   
    * @param size  ,    
   */
-  Var(VarTypes type, int size = 0) : data_(type) {
-    if (size > 0) {
-      for (int i = 0; i < size; ++i) {
-        array_.push_back(new Var(type));
-      }
-    }
-  }
+  Var(VarTypes type, int size = 0) : data_(type), size_(size) {}
   /*!
    * @brief   
   */
   Var() : data_(Int) {}
 
-  
   VarData data_; ///< ,   
-
-  std::vector<Var*> array_; ///<    ,      
+  int size_ = 0; ///<  , 0    .  -  size_ 
 };
+static_assert(std::is_trivially_copyable<Var>::value,
+              "frames are copied as plain memory");
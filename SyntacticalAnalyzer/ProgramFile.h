@@ -0,0 +1,593 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Bytecode.h"
+#include "ComponentsInfo.h"
+#include "Interpreter.h"
+#include "MappedFile.h"
+#include "Poliz.h"
+/*!
+ * \file
+ * \brief      
+ */
+
+/*!
+ * \brief  ,    
+ *
+ *      ,    4    
+ * ,  -   :
+ * - : "DCPF",  ,    ( main);
+ * - :   -;
+ * - : ,      ;
+ * -  :     ;
+ * - : ,    ,   ,
+ *     ,       .
+ *
+ *     ,      
+ *  (0,    ).
+ *
+ *    ,       
+ * ,   ,   ,
+ *      . ,    
+ *  
+ */
+class ProgramFile {
+ public:
+  static constexpr uint32_t kVersion = 5;  ///<  
+
+  /*!
+   * @brief     
+   * @param file_name   
+   * @param code - 
+   * @param funcs  
+   * @param globals      
+   * @param entry   main  
+   * @throw std::invalid_argument     
+   */
+  static void Write(const std::string& file_name, const Bytecode& code,
+                    const std::deque<FunctionInfo>& funcs,
+                    const std::vector<Var>& globals, int entry) {
+    std::string out(kMagic, sizeof(kMagic));
+    PutU32(out, kVersion);
+    PutU32(out, entry);
+
+    PutU32(out, static_cast<uint32_t>(code.size()));
+    out.append(reinterpret_cast<const char*>(code.data()), code.size());
+
+    PutU32(out, static_cast<uint32_t>(code.consts().size()));
+    for (const VarData& data : code.consts()) PutData(out, data, code.strings());
+
+    PutFrame(out, globals);
+
+    PutU32(out, static_cast<uint32_t>(funcs.size()));
+    for (const FunctionInfo& func : funcs) {
+      PutString(out, func.name());
+      out.push_back(static_cast<char>(func.type().base));
+      out.push_back(static_cast<char>(func.type().kind));
+      PutU32(out, func.poliz_start());
+      PutU32(out, static_cast<uint32_t>(func.args().size()));
+      for (const auto& arg : func.args()) {
+        out.push_back(static_cast<char>(arg.first.base));
+        out.push_back(static_cast<char>(arg.first.kind));
+      }
+      PutFrame(out, func.frame());
+    }
+
+    std::ofstream stream(file_name, std::ios::binary);
+    if (!stream) {
+      throw std::invalid_argument("Can't open file " + file_name);
+    }
+    stream.write(out.data(), out.size());
+  }
+
+  /*!
+   * @brief        
+   * @param file_name   
+   * @throw std::invalid_argument     ,  
+   *   
+   */
+  explicit ProgramFile(const std::string& file_name) : file_(file_name) {
+    Reader in{file_.data(), file_.data() + file_.size()};
+    if (in.Bytes(sizeof(kMagic)) != std::string_view(kMagic, sizeof(kMagic))) {
+      throw std::invalid_argument(file_name + " is not a program file");
+    }
+    if (in.U32() != kVersion) {
+      throw std::invalid_argument("Unsupported program file version");
+    }
+    entry_ = in.U32();
+
+    uint32_t code_size = in.U32();
+    code_ = Bytecode(reinterpret_cast<const uint8_t*>(in.Bytes(code_size).data()),
+                     code_size);
+
+    for (uint32_t i = 0, n = in.U32(); i < n; ++i) code_.AddConst(in.Data(code_.strings()));
+
+    globals_ = in.Frame();
+
+    for (uint32_t i = 0, n = in.U32(); i < n; ++i) {
+      std::string name(in.String());
+      TypeDesc type = in.Desc();
+      int poliz_start = in.U32();
+      uint32_t args_count = in.U32();
+      //      2 
+      if (args_count > static_cast<size_t>(in.end - in.cur) / 2) {
+        throw std::invalid_argument("Corrupted program file");
+      }
+      std::vector<std::pair<TypeDesc, int>> args(args_count);
+      for (auto& arg : args) arg = {in.Desc(), -1};
+      FunctionInfo func(type, name, -1, std::move(args));
+      func.set_poliz_start(poliz_start);
+      func.set_frame(in.Frame());
+      if (func.args().size() > func.frame().size()) {
+        throw std::invalid_argument("Corrupted program file");
+      }
+      funcs_.push_back(std::move(func));
+    }
+    Validate();
+  }
+
+  ProgramFile(const ProgramFile&) = delete;
+  ProgramFile& operator=(const ProgramFile&) = delete;
+
+  /*!
+   * @brief   
+   */
+  void Launch() {
+    Interpreter interpreter(funcs_, code_, globals_);
+    interpreter.Launch(entry_);
+  }
+
+ private:
+  static constexpr char kMagic[4] = {'D', 'C', 'P', 'F'};  ///<  
+
+  //!      
+  struct Reader {
+    const char* cur;  ///<  
+    const char* end;  ///<  
+
+    std::string_view Bytes(size_t size) {
+      if (static_cast<size_t>(end - cur) < size) {
+        throw std::invalid_argument("Corrupted program file");
+      }
+      std::string_view res(cur, size);
+      cur += size;
+      return res;
+    }
+    uint8_t U8() { return static_cast<uint8_t>(Bytes(1)[0]); }
+    uint32_t U32() {
+      uint32_t res;
+      std::memcpy(&res, Bytes(sizeof(res)).data(), sizeof(res));
+      return res;
+    }
+    std::string_view String() { return Bytes(U32()); }
+    VarTypes Type() {
+      uint8_t type = U8();
+      if (type > VarTypes::String) {
+        throw std::invalid_argument("Corrupted program file");
+      }
+      return static_cast<VarTypes>(type);
+    }
+    TypeDesc Desc() {
+      uint8_t base = U8(), kind = U8();
+      if (base >= static_cast<uint8_t>(BaseTypes::Count) ||
+          kind >= static_cast<uint8_t>(ValueKinds::Count)) {
+        throw std::invalid_argument("Corrupted program file");
+      }
+      return TypeDesc(static_cast<BaseTypes>(base),
+                      static_cast<ValueKinds>(kind));
+    }
+    //! ;       
+    std::vector<Var> Frame() {
+      uint32_t size = U32();
+      //     5 ,      
+      if (size > static_cast<size_t>(end - cur) / 5) {
+        throw std::invalid_argument("Corrupted program file");
+      }
+      std::vector<Var> res(size);
+      for (size_t i = 0; i < res.size(); ++i) {
+        VarTypes type = Type();
+        res[i] = Var(type, U32());
+        if (res[i].size_ < 0 ||
+            static_cast<size_t>(res[i].size_) >= res.size() - i) {
+          throw std::invalid_argument("Corrupted program file");
+        }
+      }
+      return res;
+    }
+    VarData Data(StringHeap& strings) {
+      VarTypes type = Type();
+      switch (type) {
+        case Int: {
+          uint32_t val = U32();
+          return VarData(static_cast<int>(val));
+        }
+        case Char:
+          return VarData(static_cast<char>(U8()));
+        case Float: {
+          uint32_t bits = U32();
+          float val;
+          std::memcpy(&val, &bits, sizeof(val));
+          return VarData(val);
+        }
+        case Bool:
+          return VarData(U8() != 0);
+        default:
+          return VarData::Constant(strings, String());
+      }
+    }
+  };
+
+  static void PutU32(std::string& out, uint32_t val) {
+    out.append(reinterpret_cast<const char*>(&val), sizeof(val));
+  }
+  static void PutString(std::string& out, std::string_view str) {
+    PutU32(out, static_cast<uint32_t>(str.size()));
+    out.append(str);
+  }
+  static void PutFrame(std::string& out, const std::vector<Var>& frame) {
+    PutU32(out, static_cast<uint32_t>(frame.size()));
+    for (const Var& var : frame) {
+      out.push_back(static_cast<char>(var.data_.type_));
+      PutU32(out, static_cast<uint32_t>(var.size_));
+    }
+  }
+  static void PutData(std::string& out, const VarData& data,
+                      const StringHeap& strings) {
+    out.push_back(static_cast<char>(data.type_));
+    switch (data.type_) {
+      case Int:
+        PutU32(out, static_cast<uint32_t>(data.int_));
+        break;
+      case Char:
+        out.push_back(data.char_);
+        break;
+      case Float: {
+        uint32_t bits;
+        std::memcpy(&bits, &data.float_, sizeof(bits));
+        PutU32(out, bits);
+        break;
+      }
+      case Bool:
+        out.push_back(data.bool_);
+        break;
+      default:
+        PutString(out, data.str(strings));
+    }
+  }
+  /*!
+   * @brief ,    :   , 
+   *     , ,   
+   *
+   *            
+   * main,            .  main
+   *      .    
+   * CheckStack
+   * @throw std::invalid_argument   
+   */
+  void Validate() const {
+    std::vector<bool> starts(code_.size() + 1);
+    std::vector<size_t> targets = {entry_};
+    std::map<size_t, size_t> frames = {{0, 0}, {entry_, 0}};
+    for (const FunctionInfo& func : funcs_) {
+      targets.push_back(func.poliz_start());
+      frames[func.poliz_start()] = func.frame().size();
+    }
+    for (size_t pos = 0; pos < code_.size();) {
+      starts[pos] = true;
+      if (code_.data()[pos] >= static_cast<uint8_t>(OpCodes::Count)) {
+        throw std::invalid_argument("Corrupted program file");
+      }
+      OpCodes op = code_.op(pos);
+      size_t next = pos + 1 + 4 * OperandCount(op);
+      if (next > code_.size()) {
+        throw std::invalid_argument("Corrupted program file");
+      }
+      bool valid = true;
+      if (op == OpCodes::Var) valid = code_.operand(pos + 1) < globals_.size();
+      if (op == OpCodes::Local) {
+        valid =
+            code_.operand(pos + 1) < std::prev(frames.upper_bound(pos))->second;
+      }
+      if (op == OpCodes::Const) {
+        valid = code_.operand(pos + 1) < code_.consts().size();
+      }
+      if (op == OpCodes::Call) {
+        uint32_t func = code_.operand(pos + 5);
+        valid = func < funcs_.size() &&
+                code_.operand(pos + 1) == funcs_[func].args().size();
+      }
+      if (op == OpCodes::ToFloat) valid = code_.operand(pos + 1) <= 1;
+      if (op == OpCodes::Cast) {
+        valid = code_.operand(pos + 1) < static_cast<uint32_t>(kVarTypesCount);
+      }
+      if (IsJump(op)) targets.push_back(code_.operand(pos + 1));
+      if (!valid) throw std::invalid_argument("Corrupted program file");
+      pos = next;
+    }
+    for (size_t target : targets) {
+      if (target >= code_.size() || !starts[target]) {
+        throw std::invalid_argument("Corrupted program file");
+      }
+    }
+    CheckStack(targets);
+  }
+
+  /*!
+   * @brief      
+   */
+  struct StackSlot {
+    bool var = false;   ///< ,   ,   
+    int32_t count = -1;  ///<    >= 0,      ,  -1
+  };
+  /*!
+   * @brief ,       
+   */
+  struct StackState {
+    std::vector<StackSlot> stack;  ///<       
+    size_t frame = 0;              ///<    
+  };
+
+  /*!
+   * @brief ,          
+   *
+   *     main   ,    
+   * ,      -  ,   .
+   *         ;, 
+   *  ,     ,    .
+   *      ,    
+   * ,    ,      
+   * .   return     
+   *  ,       . ,
+   *       ,    ,
+   * , ++, --,     , 
+   *  in  out -  ,      
+   * @param targets     
+   * @throw std::invalid_argument     
+   */
+  void CheckStack(const std::vector<size_t>& targets) const {
+    auto corrupted = []() {
+      return std::invalid_argument("Corrupted program file");
+    };
+    std::vector<bool> joins(code_.size());
+    for (size_t target : targets) joins[target] = true;
+    std::unordered_map<size_t, StackState> states;
+    std::vector<size_t> work;
+    //   ,     
+    auto reach = [&](size_t pos, const StackState& st) {
+      auto found = states.find(pos);
+      if (found == states.end()) {
+        states.emplace(pos, st);
+        work.push_back(pos);
+        return;
+      }
+      StackState& cur = found->second;
+      bool changed = st.frame < cur.frame;
+      cur.frame = std::min(cur.frame, st.frame);
+      if (st.stack.size() < cur.stack.size()) {
+        cur.stack.erase(cur.stack.begin(),
+                        cur.stack.end() - st.stack.size());
+        changed = true;
+      }
+      //    
+      size_t shift = st.stack.size() - cur.stack.size();
+      for (size_t i = 0; i < cur.stack.size(); ++i) {
+        StackSlot& slot = cur.stack[i];
+        const StackSlot& other = st.stack[shift + i];
+        if (slot.var && !other.var) slot.var = false, changed = true;
+        if (slot.count != other.count && slot.count != -1) {
+          slot.count = -1, changed = true;
+        }
+      }
+      if (changed) work.push_back(pos);
+    };
+    reach(entry_, StackState());
+    for (const FunctionInfo& func : funcs_) {
+      reach(func.poliz_start(), StackState{{}, func.frame().size()});
+    }
+
+    while (!work.empty()) {
+      size_t pos = work.back();
+      work.pop_back();
+      StackState st = states.at(pos);
+      std::vector<StackSlot>& stack = st.stack;
+      auto need = [&](size_t n) {
+        if (stack.size() < n) throw corrupted();
+      };
+      auto pop = [&]() {
+        need(1);
+        StackSlot res = stack.back();
+        stack.pop_back();
+        return res;
+      };
+      auto need_var = [&]() {
+        need(1);
+        if (!stack.back().var) throw corrupted();
+      };
+      const StackSlot kValue, kVar{true};
+      while (true) {
+        OpCodes op = code_.op(pos);
+        size_t next = pos + 1 + 4 * OperandCount(op);
+        bool falls = true;
+        switch (op) {
+          case OpCodes::Nop:
+          case OpCodes::Comma:
+            break;
+          case OpCodes::Local:
+            if (code_.operand(pos + 1) >= st.frame) throw corrupted();
+            stack.push_back(kVar);
+            break;
+          case OpCodes::Var:
+            stack.push_back(kVar);
+            break;
+          case OpCodes::Const: {
+            const VarData& data = code_.consts()[code_.operand(pos + 1)];
+            StackSlot slot;
+            if (data.type_ == Int && data.int_ >= 0) slot.count = data.int_;
+            stack.push_back(slot);
+            break;
+          }
+          case OpCodes::Jump:
+            reach(code_.operand(pos + 1), st);
+            falls = false;
+            break;
+          case OpCodes::JumpFalse:
+            pop();
+            reach(code_.operand(pos + 1), st);
+            break;
+          case OpCodes::Call:
+            need(code_.operand(pos + 1));
+            stack.resize(stack.size() - code_.operand(pos + 1));
+            stack.push_back(kValue);
+            break;
+          case OpCodes::Return:
+            pop();
+            falls = false;
+            break;
+          case OpCodes::In:
+          case OpCodes::Out: {
+            int32_t count = pop().count;
+            if (count < 0) throw corrupted();
+            need(count);
+            for (size_t i = stack.size() - count; i < stack.size(); ++i) {
+              if (op == OpCodes::In && !stack[i].var) throw corrupted();
+            }
+            stack.resize(stack.size() - count);
+            break;
+          }
+          case OpCodes::PostInc:
+          case OpCodes::PostDec:
+            need_var();
+            stack.push_back(kValue);
+            break;
+          case OpCodes::PostNot:
+            pop();
+            stack.push_back(kValue);
+            break;
+          case OpCodes::Index:
+            pop();
+            need_var();
+            stack.push_back(kVar);
+            break;
+          case OpCodes::PreInc:
+          case OpCodes::PreDec:
+            need_var();
+            stack.push_back(kVar);
+            break;
+          case OpCodes::PreNot:
+          case OpCodes::UnPlus:
+          case OpCodes::UnMinus:
+            need(1);
+            stack.push_back(kValue);
+            break;
+          case OpCodes::Pow:
+          case OpCodes::Mul:
+          case OpCodes::Div:
+          case OpCodes::Mod:
+          case OpCodes::Add:
+          case OpCodes::Sub:
+          case OpCodes::Less:
+          case OpCodes::LessEq:
+          case OpCodes::Greater:
+          case OpCodes::GreaterEq:
+          case OpCodes::Eq:
+          case OpCodes::Ne:
+          case OpCodes::And:
+          case OpCodes::Or:
+            pop();
+            pop();
+            stack.push_back(kValue);
+            break;
+          case OpCodes::Assign:
+          case OpCodes::AddAssign:
+          case OpCodes::SubAssign:
+          case OpCodes::MulAssign:
+          case OpCodes::DivAssign:
+          case OpCodes::ModAssign:
+          case OpCodes::AssignInt:
+          case OpCodes::AddAssignInt:
+          case OpCodes::SubAssignInt:
+          case OpCodes::AssignFloat:
+          case OpCodes::AddAssignFloat:
+          case OpCodes::SubAssignFloat:
+            pop();
+            need_var();
+            stack.push_back(kVar);
+            break;
+          case OpCodes::Pop:
+            pop();
+            stack.clear();
+            break;
+          case OpCodes::AddInt:
+          case OpCodes::SubInt:
+          case OpCodes::MulInt:
+          case OpCodes::DivInt:
+          case OpCodes::ModInt:
+          case OpCodes::LessInt:
+          case OpCodes::LessEqInt:
+          case OpCodes::GreaterInt:
+          case OpCodes::GreaterEqInt:
+          case OpCodes::EqInt:
+          case OpCodes::NeInt:
+          case OpCodes::AddFloat:
+          case OpCodes::SubFloat:
+          case OpCodes::MulFloat:
+          case OpCodes::DivFloat:
+          case OpCodes::ModFloat:
+          case OpCodes::LessFloat:
+          case OpCodes::LessEqFloat:
+          case OpCodes::GreaterFloat:
+          case OpCodes::GreaterEqFloat:
+          case OpCodes::EqFloat:
+          case OpCodes::NeFloat:
+          case OpCodes::Concat:
+            pop();
+            need(1);
+            stack.back() = kValue;
+            break;
+          case OpCodes::ToFloat:
+            need(code_.operand(pos + 1) + 1);
+            stack[stack.size() - 1 - code_.operand(pos + 1)] = kValue;
+            break;
+          case OpCodes::Cast:
+            need(1);
+            stack.back() = kValue;
+            break;
+          case OpCodes::AndJump:
+          case OpCodes::OrJump: {
+            need(1);
+            StackState jumped = st;
+            jumped.stack.back() = kValue;
+            reach(code_.operand(pos + 1), jumped);
+            stack.pop_back();
+            break;
+          }
+          default:
+            throw corrupted();
+        }
+        if (!falls) break;
+        if (next >= code_.size()) throw corrupted();
+        if (joins[next]) {
+          reach(next, st);
+          break;
+        }
+        pos = next;
+      }
+    }
+  }
+  MappedFile file_;                 ///<  
+  Bytecode code_;                   ///< ,    
+  std::vector<Var> globals_;        ///<     
+  std::deque<FunctionInfo> funcs_;  ///<  
+  uint32_t entry_ = 0;              ///<   main
+};
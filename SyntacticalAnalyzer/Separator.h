@@ -1,8 +1,16 @@
 #pragma once
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <thread>
 #include <vector>
+#include "Lexeme.h"
+#include "LexemeTables.h"
+#include "MappedFile.h"
+#include "SimdScan.h"
+#include "TokenBuffer.h"
 /*!
 * \file
 * \brief     Separator
@@ -10,226 +18,387 @@
 
 /*!
 * \brief   
-* 
-*          -  .         ("text.txt"),    DC++,       ,    ,     ("separated.txt")
+*
+*          -  .         ("text.txt"),    DC++,       ,    ,    .        ,   ("separated.txt")    
+*
+*    :           256 ,       .      ,    ,       
+*
+*   ,     *          SimdScan.h    16  32 
+*
+*         ,     , . SplitParallel
 */
 class Separator {
  public:
   /*!
-   * @brief   
+   * @brief    
+   * @param file_name    
+   *         .
+   *  ,    ,      
   */
-  Separator() {
-    std::ifstream is("reserved.txt");
-    while (!is.eof()) {
-      std::string now;
-      is >> now;
-      reserved.push_back(now);
-    }
-    os.open("separated.txt");
-    last = ' ';
-    now = "";
-    type = 0;
+  void unload(std::string file_name) {
+    auto file = std::make_shared<MappedFile>(file_name);
+    Split(file->data(), file->data() + file->size(), file);
   }
 
   /*!
-   * @brief     
-   * @param c ,      
-   * @return  
+   * @brief    ,    
+   * @param begin      
+   * @param end      
+   * @param owner  ,      
+   *    .    ,  
+   *  ,   .    
+   *   
   */
-  int getType(char c) {
-    if (c == '(' || c == ')') return 6;
-    if (c == '[' || c == ']') return 7;
-    if (c == '{' || c == '}') return 8;
-    if (c == '<' || c == '>') return 9;
-    if (c == ';') return 5;
-    return 4;
+  void Split(const char* begin, const char* end,
+             std::shared_ptr<MappedFile> owner = nullptr) {
+    lexemes_.Reset(begin, std::move(owner));
+    ScanState st;
+    st.line = 1;
+    size_t chunks = std::min<size_t>(threads_, (end - begin) / kMinChunkSize);
+    if (chunks > 1) {
+      SplitParallel(begin, end, chunks, st);
+    } else {
+      Scan(begin, end, st, lexemes_);
+    }
+    Emit(st.state, st.lexeme, end, st.lexeme_line, lexemes_);
+    lexemes_.InternSymbols();
   }
 
   /*!
-   * @brief ,    
-   * @param c ,   
-   * @return true  false 
+   * @brief  threads_
+   * @param threads        
   */
-  bool isLetter(char c) {
-    return ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_');
-  }
+  void set_threads(unsigned threads) { threads_ = std::max(1u, threads); }
 
   /*!
-   * @brief ,    
-   * @param c ,   
-   * @return true  false 
-   */
-  bool isDigit(char c) { return (c >= '0' && c <= '9'); }
-  
+   * @brief  lexemes_
+   * @return     ,       
+  */
+  TokenBuffer& lexemes() { return lexemes_; }
+
   /*!
-   * @brief ,         
-   * @param c ,   
-   * @return true  false 
-   */
-  bool isDivider(char c) {
-    return (c == '(' || c == ')' || c == '{' || c == '}' || c == '[' ||
-            c == ']' || c == '<' || c == '>' || c == '+' || c == '-' ||
-            c == '^' || c == '|' || c == '&' || c == '%' || c == '/' ||
-            c == '*' || c == ':' || c == '!' || c == '=' || c == ' ' ||
-            c == '"' || c == '?' || c == '\n' || c == '\t' || c == ',' ||
-            c == ';' || c == '.');
+   * @brief        "  ".   
+   * @param file_name ,     
+  */
+  void Dump(const std::string& file_name) const {
+    std::ofstream os(file_name);
+    for (size_t i = 0; i < lexemes_.size(); ++i) {
+      os << lexemes_.text(i) << ' ' << static_cast<int>(lexemes_.type(i)) << ' '
+         << lexemes_.line(i) << '\n';
+    }
   }
 
+ private:
   /*!
-   * @brief 
-   * @param c 
-   * @return 
+   * @brief  .      
   */
-  bool onceDivider(char c) {
-    return (c == '(' || c == ')' || c == '{' || c == '}' || c == '[' ||
-            c == ']' || c == ';' || c == '.' || c == '*');
-  }
+  enum CharClasses {
+    kOther,      ///< ,     
+    kLetter,     ///<   _
+    kDigit,      ///< 
+    kSpace,      ///<  
+    kQuote,      ///< 
+    kSlash,      ///< /
+    kStar,       ///< *
+    kDot,        ///< .
+    kPlus,       ///< +
+    kMinus,      ///< -
+    kLess,       ///< <
+    kGreater,    ///< >
+    kEqual,      ///< =
+    kBang,       ///< !
+    kAmp,        ///< &
+    kPipe,       ///< |
+    kPercent,    ///< %
+    kCaret,      ///< ^
+    kColon,      ///< :
+    kRound,      ///<  
+    kSquare,     ///<  
+    kCurly,      ///<  
+    kSemicolon,  ///< ;
+    kSingle,     ///<   ?
+    kClassesCount
+  };
+
+  /*!
+   * @brief  .     kAcceptTypes   ,      
+  */
+  enum States {
+    kStart,        ///<  ,    
+    kIdent,        ///<    
+    kNumber,       ///<   
+    kNumberDot,    ///<   
+    kFraction,     ///<   
+    kBad,          ///<  ,   
+    kString,       ///<   
+    kStringEnd,    ///<    
+    kSlashOp,      ///< / -    
+    kComment,      ///<  
+    kCommentStar,  ///< *  
+    kPlusOp,       ///< +
+    kMinusOp,      ///< -
+    kStarOp,       ///< *
+    kLessOp,       ///< <
+    kGreaterOp,    ///< >
+    kEqualOp,      ///< =
+    kBangOp,       ///< !
+    kAmpOp,        ///< &
+    kPipeOp,       ///< |
+    kPercentOp,    ///< %
+    kCaretOp,      ///< ^
+    kColonOp,      ///< :
+    kDoubleOp,     ///<    
+    kSingleOp,     ///<    : . , ?
+    kRoundBrace,   ///<  
+    kSquareBrace,  ///<  
+    kCurlyBrace,   ///<  
+    kSemicolonOp,  ///< ;
+    kStatesCount,
+    kEmit = kStatesCount  ///<  ,   
+  };
 
-  bool equalOperation(char c) {
-    return (c == '+' || c == '-' || c == '*' || c == '/' || c == '!' ||
-            c == '|' || c == '&' || c == '%' || c == '^' || c == '=');
+  /*!
+   * @brief  ,     
+  */
+  struct ScanState {
+    int state = kStart;            ///<   
+    const char* lexeme = nullptr;  ///<   
+    int lexeme_line = 0;           ///< ,    
+    int line = 0;                  ///<  
+  };
+
+  //!         
+  static constexpr size_t kMinChunkSize = 1 << 20;
+
+  /*!
+   * @brief  :    
+  */
+  struct Tables {
+    unsigned char classes[256];  ///<   
+    unsigned char transitions[kStatesCount][kClassesCount];  ///<  
+  };
+
+  /*!
+   * @brief      
+   * @return  
+  */
+  static const Tables& GetTables() {
+    static const Tables tables = BuildTables();
+    return tables;
   }
 
-  bool doubleOperation(char c) {
-    return (c == '+' || c == '-' || c == '*' || c == '|' || c == '&' ||
-            c == '=' || c == '<' || c == '>' || c == ':');
+  static Tables BuildTables() {
+    Tables t;
+    for (int c = 0; c < 256; ++c) t.classes[c] = kOther;
+    for (int c = 'a'; c <= 'z'; ++c) t.classes[c] = kLetter;
+    for (int c = 'A'; c <= 'Z'; ++c) t.classes[c] = kLetter;
+    t.classes['_'] = kLetter;
+    for (int c = '0'; c <= '9'; ++c) t.classes[c] = kDigit;
+    t.classes[' '] = t.classes['\t'] = t.classes['\r'] = t.classes['\n'] =
+        kSpace;
+    t.classes['"'] = kQuote;
+    t.classes['/'] = kSlash;
+    t.classes['*'] = kStar;
+    t.classes['.'] = kDot;
+    t.classes['+'] = kPlus;
+    t.classes['-'] = kMinus;
+    t.classes['<'] = kLess;
+    t.classes['>'] = kGreater;
+    t.classes['='] = kEqual;
+    t.classes['!'] = kBang;
+    t.classes['&'] = kAmp;
+    t.classes['|'] = kPipe;
+    t.classes['%'] = kPercent;
+    t.classes['^'] = kCaret;
+    t.classes[':'] = kColon;
+    t.classes['('] = t.classes[')'] = kRound;
+    t.classes['['] = t.classes[']'] = kSquare;
+    t.classes['{'] = t.classes['}'] = kCurly;
+    t.classes[';'] = kSemicolon;
+    t.classes[','] = t.classes['?'] = kSingle;
+
+    for (int s = 0; s < kStatesCount; ++s) {
+      for (int c = 0; c < kClassesCount; ++c) t.transitions[s][c] = kEmit;
+    }
+    auto set = [&t](int state, int c, int next) {
+      t.transitions[state][c] = next;
+    };
+
+    const unsigned char from_start[kClassesCount] = {
+        kBad,        kIdent,     kNumber,      kStart,      kString,
+        kSlashOp,    kStarOp,    kSingleOp,    kPlusOp,     kMinusOp,
+        kLessOp,     kGreaterOp, kEqualOp,     kBangOp,     kAmpOp,
+        kPipeOp,     kPercentOp, kCaretOp,     kColonOp,    kRoundBrace,
+        kSquareBrace, kCurlyBrace, kSemicolonOp, kSingleOp};
+    for (int c = 0; c < kClassesCount; ++c) set(kStart, c, from_start[c]);
+
+    set(kIdent, kLetter, kIdent);
+    set(kIdent, kDigit, kIdent);
+    set(kIdent, kOther, kBad);
+
+    set(kNumber, kDigit, kNumber);
+    set(kNumber, kDot, kNumberDot);
+    set(kNumberDot, kDigit, kFraction);
+    set(kFraction, kDigit, kFraction);
+    for (int s : {kNumber, kNumberDot, kFraction, kBad}) {
+      set(s, kLetter, kBad);
+      set(s, kOther, kBad);
+    }
+    set(kBad, kDigit, kBad);
+
+    for (int c = 0; c < kClassesCount; ++c) {
+      set(kString, c, kString);
+      set(kComment, c, kComment);
+      set(kCommentStar, c, kComment);
+    }
+    set(kString, kQuote, kStringEnd);
+    set(kSlashOp, kStar, kComment);
+    set(kComment, kStar, kCommentStar);
+    set(kCommentStar, kStar, kCommentStar);
+    set(kCommentStar, kSlash, kStart);
+
+    set(kSlashOp, kEqual, kDoubleOp);
+    set(kPlusOp, kPlus, kDoubleOp);
+    set(kMinusOp, kMinus, kDoubleOp);
+    set(kStarOp, kStar, kDoubleOp);
+    set(kLessOp, kLess, kDoubleOp);
+    set(kGreaterOp, kGreater, kDoubleOp);
+    set(kEqualOp, kEqual, kDoubleOp);
+    set(kAmpOp, kAmp, kDoubleOp);
+    set(kPipeOp, kPipe, kDoubleOp);
+    set(kColonOp, kColon, kDoubleOp);
+    for (int s : {kPlusOp, kMinusOp, kStarOp, kLessOp, kGreaterOp, kBangOp,
+                  kAmpOp, kPipeOp, kPercentOp, kCaretOp}) {
+      set(s, kEqual, kDoubleOp);
+    }
+    return t;
   }
 
   /*!
-   * @brief ,      
-   * @param s ,   
-   * @return true  false 
+   * @brief     
+   * @param begin  
+   * @param end  
+   * @param st      ,   -   .
+   * ,     ,  ,    st
+   * @param out ,    
   */
-  bool isReserved(std::string& s) {
-    for (int i = 0; i < reserved.size(); ++i) {
-      if (s == reserved[i]) {
-        return true;
+  static void Scan(const char* begin, const char* end, ScanState& st,
+                   TokenBuffer& out) {
+    const Tables& tables = GetTables();
+    int line = st.line;
+    int state = st.state;
+    const char* lexeme = st.lexeme;
+    int lexeme_line = st.lexeme_line;
+    for (const char* cur = begin; cur != end; ++cur) {
+      if (state == kStart) {
+        cur = scan::SkipSpaces(cur, end, line);
+      } else if (state == kComment) {
+        cur = scan::FindChar(cur, end, '*', line);
+      } else if (state == kString) {
+        cur = scan::FindChar(cur, end, '"', line);
+      }
+      if (cur == end) break;
+      unsigned char c = *cur;
+      if (state == kStart) {
+        lexeme = cur;
+        lexeme_line = line;
+      }
+      int next = tables.transitions[state][tables.classes[c]];
+      if (next == kEmit) {
+        Emit(state, lexeme, cur, lexeme_line, out);
+        lexeme = cur;
+        lexeme_line = line;
+        next = tables.transitions[kStart][tables.classes[c]];
       }
+      line += c == '\n';
+      state = next;
     }
-    return false;
+    st = {state, lexeme, lexeme_line, line};
   }
 
   /*!
-   * @brief     
-   * @param x  ,     
+   * @brief      
+   * @param begin  
+   * @param end  
+   * @param chunks     
+   * @param st  ,   -   
+   *
+   *       .    
+   *      ,    
+   *  .  ,  ,   
+   *   ,      ,  
+   *   .     :   
+   *     ,   
+   *    ,    , 
+   *  
   */
-  void out(int x) {
-    if (now == "") return;
-    if (isReserved(now)) {
-      os << now << " " << 1 << ' ' << line << '\n';
-    } else {
-      os << now << " " << x << ' ' << line << '\n';
+  void SplitParallel(const char* begin, const char* end, size_t chunks,
+                     ScanState& st) {
+    std::vector<const char*> bounds{begin};
+    for (size_t i = 1; i < chunks; ++i) {
+      const char* bound =
+          std::max(begin + (end - begin) * i / chunks, bounds.back());
+      bound = std::find(bound, end, '\n');
+      bounds.push_back(bound == end ? end : bound + 1);
+    }
+    bounds.push_back(end);
+
+    GetTables();
+    std::vector<TokenBuffer> parts(chunks);
+    std::vector<ScanState> exits(chunks);
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < chunks; ++i) {
+      workers.emplace_back([&, i] {
+        parts[i].Reset(begin);
+        Scan(bounds[i], bounds[i + 1], exits[i], parts[i]);
+      });
+    }
+    Scan(bounds[0], bounds[1], st, lexemes_);
+    for (auto& worker : workers) worker.join();
+
+    for (size_t i = 1; i < chunks; ++i) {
+      if (st.state == kStart) {
+        lexemes_.Append(parts[i], st.line);
+        exits[i].lexeme_line += st.line;
+        exits[i].line += st.line;
+        st = exits[i];
+      } else {
+        Scan(bounds[i], bounds[i + 1], st, lexemes_);
+      }
     }
-    now.clear();
-    last = ' ';
-    type = 0;
   }
 
   /*!
-   * @brief   
-   * @param file_name    
+   * @brief  ,    state,   
+   * @param state  ,    
+   * @param begin     
+   * @param end   ,   
+   * @param line ,    
+   * @param out ,    
   */
-  void unload(std::string file_name) {
-    std::ifstream is(file_name);
-    // -1 - none of them, 0 - begin
-    bool comment = false;
-    bool string = false;
-    while (!is.eof()) {
-      char c;
-      is.get(c);
-      if (is.eof()) break;
-      if (c == '\n') {
-        line++;
-      }
-      if (last == '/' && c == '*') {
-        now.clear();
-        type = 0;
-        comment = true;
-      }
-      if (last == '*' && c == '/') {
-        now.clear();
-        comment = false;
-        type = 0;
-        last = ' ';
-        continue;
-      }
-      if (comment) {
-        last = c;
-        continue;
-      }
-      if (c == '"') {
-        if (string) {
-          out(10);
-        } else {
-          //out(type);
-        }
-        //now += '"';
-        //out(11);
-        string = !string;
-        continue;
-      }
-      if (string) {
-        now += c;
-        continue;
-      }
-      if ((last == '<' || last == '>') && !isDivider(c)) {
-        out(9);
-      }
-      if (last == '/' && !isDivider(c)) {
-        out(4);
-      }
-      if ((doubleOperation(last) && c == last) ||
-          (equalOperation(last) && c == '=')) {
-        now += c;
-        out(4);
-        continue;
-      }
-      if (isDivider(c)) {
-        out(type);
-        if (c != ' ' && c != '\n' && c != '\t') {
-          now += c;
-          last = c;
-          type = getType(c);
-        }
-        if (onceDivider(c)) {
-          out(getType(c));
-        }
-        continue;
-      } else if (isDivider(last)) {
-        out(type);
-        type = 0;
-        last = ' ';
-        now = "";
-      }
-      if (type == 0) {
-        if (isLetter(c)) {
-          type = 2;
-        } else if (isDigit(c)) {
-          type = 3;
-        } else {
-          type = -1;
-        }
-      } else if (type == 2) {
-        if (!(isLetter(c) || isDigit(c))) {
-          type = -1;
-        }
-      } else if (type == 3) {
-        if (isLetter(c)) {
-          type = -1;
-        }
-      }
-      now += c;
-      last = c;
+  static void Emit(int state, const char* begin, const char* end, int line,
+                   TokenBuffer& out) {
+    //    ,      ,
+    //    
+    static const int kAcceptTypes[kStatesCount] = {
+        0,  2, 3, 3, 3, -1, -1, 10, 4, -1, -1, 4, 4, 4, 9,
+        9,  4, 4, 4, 4, 4,  4,  4,  4, 4,  6,  7, 8, 5};
+    int type = kAcceptTypes[state];
+    if (type == 0) return;
+    if (state == kStringEnd) {
+      ++begin, --end;
+    } else if (state == kString) {
+      ++begin;
+    }
+    std::string_view now(begin, end - begin);
+    if (state == kIdent) {
+      if (auto word = kReservedTable.Find(now)) type = word->type;
+    } else if (type == 4 || type == 9) {
+      if (auto oper = kOperationsTable.Find(now)) type = oper->type;
     }
-    out(type);
-    os.close();
+    out.Push(static_cast<LexemeTypes>(type), begin, end, line);
   }
 
- private:
-  std::vector<std::string> reserved; ///<   
-  std::ofstream os; ///<  
-  char last; ///<  
-  int type; ///<    
-  int line = 1; ///<   
-  std::string now; ///<  
-};
\ No newline at end of file
+  TokenBuffer lexemes_; ///<  
+  unsigned threads_ = std::max(1u, std::thread::hardware_concurrency()); ///<    
+};
@@ -0,0 +1,155 @@
+#pragma once
+#include <cstdint>
+#if !defined(DC_SCALAR_SCAN) && defined(__AVX2__)
+#define DC_SCAN_AVX2
+#include <immintrin.h>
+#elif !defined(DC_SCALAR_SCAN) && \
+    (defined(__SSE2__) || defined(_M_X64) ||          \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define DC_SCAN_SSE2
+#include <emmintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+/*!
+ * \file
+ * \brief        
+ *
+ *    ,    
+ *  ,     .    AVX2  
+ *  32 ,  SSE2 - 16 .   DC_SCALAR_SCAN 
+ *   ,   .  
+ *   
+ */
+
+namespace scan {
+
+/*!
+ * @brief    . mask    
+ */
+inline int LowestBit(uint32_t mask) {
+#ifdef _MSC_VER
+  unsigned long ind;
+  _BitScanForward(&ind, mask);
+  return static_cast<int>(ind);
+#else
+  return __builtin_ctz(mask);
+#endif
+}
+
+/*!
+ * @brief   
+ */
+inline int BitCount(uint32_t mask) {
+#ifdef _MSC_VER
+  mask = mask - ((mask >> 1) & 0x55555555);
+  mask = (mask & 0x33333333) + ((mask >> 2) & 0x33333333);
+  return static_cast<int>((((mask + (mask >> 4)) & 0x0F0F0F0F) * 0x01010101) >>
+                          24);
+#else
+  return __builtin_popcount(mask);
+#endif
+}
+
+/*!
+ * @brief       
+ */
+inline bool IsSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+#if defined(DC_SCAN_AVX2)
+constexpr int kBlock = 32;  ///<     
+constexpr uint32_t kBlockMask = 0xFFFFFFFF;  ///<   kBlock 
+using Vector = __m256i;
+
+inline Vector Load(const char* p) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+inline Vector Equal(Vector block, char c) {
+  return _mm256_cmpeq_epi8(block, _mm256_set1_epi8(c));
+}
+inline Vector Or(Vector a, Vector b) { return _mm256_or_si256(a, b); }
+inline uint32_t Mask(Vector v) {
+  return static_cast<uint32_t>(_mm256_movemask_epi8(v));
+}
+#elif defined(DC_SCAN_SSE2)
+constexpr int kBlock = 16;  ///<     
+constexpr uint32_t kBlockMask = 0xFFFF;  ///<   kBlock 
+using Vector = __m128i;
+
+inline Vector Load(const char* p) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+inline Vector Equal(Vector block, char c) {
+  return _mm_cmpeq_epi8(block, _mm_set1_epi8(c));
+}
+inline Vector Or(Vector a, Vector b) { return _mm_or_si128(a, b); }
+inline uint32_t Mask(Vector v) {
+  return static_cast<uint32_t>(_mm_movemask_epi8(v));
+}
+#endif
+
+/*!
+ * @brief    
+ * @param cur   
+ * @param end   
+ * @param c  
+ * @param line  ,      
+ * @return      end
+ */
+inline const char* FindChar(const char* cur, const char* end, char c,
+                            int& line) {
+#if defined(DC_SCAN_AVX2) || defined(DC_SCAN_SSE2)
+  for (; end - cur >= kBlock; cur += kBlock) {
+    Vector block = Load(cur);
+    uint32_t found = Mask(Equal(block, c));
+    uint32_t newlines = Mask(Equal(block, '\n'));
+    if (found) {
+      int ind = LowestBit(found);
+      line += BitCount(newlines & ((1u << ind) - 1));
+      return cur + ind;
+    }
+    line += BitCount(newlines);
+  }
+#endif
+  for (; cur != end && *cur != c; ++cur) line += *cur == '\n';
+  return cur;
+}
+
+/*!
+ * @brief   
+ * @param cur  
+ * @param end  
+ * @param line  ,      
+ * @return       end
+ */
+inline const char* SkipSpaces(const char* cur, const char* end, int& line) {
+#if defined(DC_SCAN_AVX2) || defined(DC_SCAN_SSE2)
+  //       ,   
+  //   
+  for (int i = 0; i < 2; ++i, ++cur) {
+    if (cur == end || !IsSpace(*cur)) return cur;
+    line += *cur == '\n';
+  }
+  for (; end - cur >= kBlock; cur += kBlock) {
+    Vector block = Load(cur);
+    Vector newline = Equal(block, '\n');
+    Vector space = Or(Or(Equal(block, ' '), Equal(block, '\t')),
+                      Or(Equal(block, '\r'), newline));
+    uint32_t other = ~Mask(space) & kBlockMask;
+    uint32_t newlines = Mask(newline);
+    if (other) {
+      int ind = LowestBit(other);
+      line += BitCount(newlines & ((1u << ind) - 1));
+      return cur + ind;
+    }
+    line += BitCount(newlines);
+  }
+#endif
+  for (; cur != end && IsSpace(*cur); ++cur) line += *cur == '\n';
+  return cur;
+}
+
+}  // namespace scan
@@ -0,0 +1,60 @@
+#pragma once
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+/*!
+ * \file
+ * \brief    
+ */
+
+/*!
+ * \brief   -      
+ *
+ *         - .
+ *      ,       
+ * .    ,   .  
+ *      
+ */
+class SymbolTable {
+ public:
+  /*!
+   * @brief   ,    ,    
+   * @param name  
+   * @return  
+   */
+  int Intern(std::string_view name) {
+    auto found = ids_.try_emplace(name, static_cast<int>(names_.size()));
+    if (found.second) names_.push_back(name);
+    return found.first->second;
+  }
+  /*!
+   * @brief   ,     
+   * @param name  
+   * @return    -1,     
+   */
+  int Find(std::string_view name) const {
+    auto found = ids_.find(name);
+    return found == ids_.end() ? -1 : found->second;
+  }
+  /*!
+   * @brief ,   
+   * @param symbol 
+   * @return  
+   */
+  std::string_view name(int symbol) const { return names_[symbol]; }
+  /*!
+   * @brief     
+   */
+  size_t size() const { return names_.size(); }
+  /*!
+   * @brief  
+   */
+  void Clear() {
+    ids_.clear();
+    names_.clear();
+  }
+
+ private:
+  std::unordered_map<std::string_view, int> ids_;  ///<  
+  std::vector<std::string_view> names_;  ///<  
+};
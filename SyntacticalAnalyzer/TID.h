@@ -3,6 +3,8 @@
 #include <vector>
 #include <stdexcept>
 #include "Poliz.h"
+#include "SymbolTable.h"
+#include "TypeDesc.h"
 
 /*!
 * \file
@@ -15,156 +17,169 @@
 /*!
 * \brief  ,     TID
 * 
-*        -      ,      
+*        -       ,      .    :     ,   ,    
 */
 class TIDRow {
  public:
   /*!
-  * \brief   TID      
+  * \brief   TID    ,    
   */
-  TIDRow(std::string name, std::string type, int size = 0)
-      : name_(name), type_(type) {
-    if (type[0] == 'l') {
-      type.erase(type.begin());
-    }
-    VarTypes var_type = ToVarType(type);
-    var_ = new Var(var_type, size);
-  }
+  TIDRow(int name, TypeDesc type, int slot, bool local)
+      : name_(name), type_(type), slot_(slot), local_(local) {}
   /*!
   * \brief    name_
-  * \return    type_
+  * \return   
   */
-  std::string name() const { return name_; }
+  int name() const { return name_; }
   /*!
    * \brief     TID
    * \return    TID
    */
-  std::string type() const { return type_; }
-
-  Var* var() const { return var_; }
+  const TypeDesc& type() const { return type_; }
+  /*!
+   * \brief   ,      -
+   */
+  int slot() const { return slot_; }
+  /*!
+   * \brief      
+   * \return true,   -    , false    
+   */
+  bool local() const { return local_; }
  private:
-  std::string name_; ///<    TID
-  std::string type_; ///<    TID
-  Var* var_; ///<  
+  int name_; ///<     TID
+  TypeDesc type_; ///<    TID
+  int slot_; ///<   
+  bool local_; ///<  -    
 };
 
 /*!
-* \brief       TID
+* \brief    
 * 
-*        ,          TID
+*      .     -    . 
+*
+*          :  TID       ,     ,     .        ,     ,   .            ,     -       
 */
-class TIDNode {
+class TIDTree {
  public:
   /*!
-  * \brief    
-  * \param parent   , nullptr   -- 
+  * \brief    .     
+  * \param symbols  ,        
   */
-  TIDNode(TIDNode* parent = nullptr) : parent_(parent) {}
+  TIDTree(const SymbolTable& symbols) : symbols_(symbols) {}
   /*!
-  * \brief    
-  * \param child  
+  * \brief    
+  * 
+  * \param name        
+  * \return  TID  .      
+  * \throw std::invalid_argument    
   */
-  void AddChild(TIDNode* child) { children_.push_back(child); }
-  /*!
-   * \brief    TID 
-   * \param row  
-   */
-  void AddRow(TIDRow row) {
-    tid_.push_back(row);
-  }
-  /*!
-   * \brief    tid_
-   * \return  TID 
-   */
-  std::vector<TIDRow> rows() const {
-    return tid_;
+  const TIDRow& GetID(int name) const {
+    if (!CheckID(name)) {
+      throw std::invalid_argument("Found no declareg variable with the name " +
+                                  std::string(symbols_.name(name)));
+    }
+    return rows_[visible_[name]].row;
   }
   /*!
-   * \brief    parent_
-   * \return    
-   */
-  TIDNode* parent() const {
-    return parent_;
+  * \brief ,          name
+  * \param name   
+  * \return true   , false  
+  */
+  bool CheckID(int name) const {
+    return name >= 0 && name < static_cast<int>(visible_.size()) &&
+           visible_[name] != -1;
   }
   /*!
-  * \brief    TID  
-  * \param name     
+  * \brief       
+  * \param name   
   * \return true   , false  
   */
-  bool FindVar(std::string name) {
-    for (auto val : tid_) {
-      if (val.name() == name) return true;
-    }
-    return false;
+  bool FindVar(int name) const {
+    return CheckID(name) && visible_[name] >= scope_start();
   }
-
- private:
-  std::vector<TIDRow> tid_; ///< TID 
-  std::vector<TIDNode*> children_; ///<  
-  TIDNode* parent_ = nullptr; ///<  
-};
-
-/*!
-* \brief    
-* 
-*      .     -    . 
-*/
-class TIDTree {
- public:
   /*!
-  * \brief       .        ,     
+  * \brief      
   */
-  TIDTree() : root_(new TIDNode), cur_(root_) {}
+  void NewScope() { scopes_.push_back(static_cast<int>(rows_.size())); }
   /*!
-  * \brief    
-  * 
-  *    GetID_     
-  * 
-  * \param name       
-  * \return  TID  
+  * \brief    .    
   */
-  TIDRow GetID(std::string name) { return GetID_(name, cur_); }
-  bool CheckID(std::string name) { return CheckID_(name, cur_); }
-  void NewScope() { 
-    auto new_child = new TIDNode(cur_);
-    cur_->AddChild(new_child);
-    cur_ = new_child;
-  }
   void Back() {
-    if (cur_ != root_) {
-      cur_ = cur_->parent();
+    if (scopes_.empty()) return;
+    while (static_cast<int>(rows_.size()) > scopes_.back()) {
+      visible_[rows_.back().row.name()] = rows_.back().shadowed;
+      rows_.pop_back();
     }
+    scopes_.pop_back();
   }
-  void Push(std::string name, std::string type, int size=0) {
-    cur_->AddRow(TIDRow(name, type, size));
+  /*!
+  * \brief      
+  *
+  *       ,    -   .       
+  * \param name   
+  * \param type  
+  * \param size  , 0    
+  */
+  void Push(int name, TypeDesc type, int size=0) {
+    if (name >= static_cast<int>(visible_.size())) visible_.resize(name + 1, -1);
+    std::vector<Var>& vars = in_frame_ ? frame_ : globals_;
+    int slot = static_cast<int>(vars.size());
+    vars.emplace_back(ToVarType(type), size);
+    vars.insert(vars.end(), size, Var(ToVarType(type)));
+    rows_.push_back({TIDRow(name, type, slot, in_frame_), visible_[name]});
+    visible_[name] = static_cast<int>(rows_.size()) - 1;
   }
-  TIDNode* cur() const { return cur_; }
-
- private:
-  TIDNode *root_, *cur_;
-  bool CheckID_(std::string name, TIDNode* node) {
-    for (auto val : node->rows()) {
-      if (val.name() == name) {
-        return true;
-      }
-    }
-    if (node == root_) {
-      return false;
-    } else {
-      return CheckID_(name, node->parent());
-    }
+  /*!
+  * \brief   :      
+  */
+  void BeginFrame() {
+    in_frame_ = true;
+    frame_.clear();
   }
-  TIDRow GetID_(std::string name, TIDNode* node) {
-    for (auto val : node->rows()) {
-      if (val.name() == name) {
-        return val;
-      }
-    }
-    if (node == root_) {
-      throw std::invalid_argument("Found no declareg variable with the name " +
-                                  name);
-    } else {
-      return GetID_(name, node->parent());
+  /*!
+  * \brief   
+  * \return      
+  */
+  std::vector<Var> EndFrame() {
+    in_frame_ = false;
+    return std::move(frame_);
+  }
+  /*!
+  * \brief        
+  * \return   TID   
+  */
+  std::vector<TIDRow> ScopeRows() const {
+    std::vector<TIDRow> res;
+    for (size_t i = scope_start(); i < rows_.size(); ++i) {
+      res.push_back(rows_[i].row);
     }
+    return res;
   }
+  /*!
+  * \brief  ,  -  
+  * \return    
+  */
+  const std::vector<Var>& globals() const { return globals_; }
+
+ private:
+  /*!
+  * \brief  TID   ,   
+  */
+  struct Entry {
+    TIDRow row; ///<  TID
+    int shadowed; ///<      , -1   
+  };
+
+  /*!
+  * \brief      
+  */
+  int scope_start() const { return scopes_.empty() ? 0 : scopes_.back(); }
+
+  std::vector<Entry> rows_; ///<  TID    
+  std::vector<int> scopes_; ///<     ,  
+  std::vector<int> visible_; ///<    -     -1
+  const SymbolTable& symbols_; ///<      
+  std::vector<Var> globals_; ///<     
+  std::vector<Var> frame_; ///<      
+  bool in_frame_ = false; ///<     
 };
@@ -0,0 +1,129 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include "Lexeme.h"
+#include "MappedFile.h"
+#include "SymbolTable.h"
+/*!
+ * \file
+ * \brief    
+ */
+
+/*!
+ * \brief  ,      
+ *
+ *      ,       ,
+ *      - 17   .   
+ * :       ,  , 
+ *  ,       std::string_view
+ */
+class TokenBuffer {
+ public:
+  /*!
+   * @brief      ,    
+   * @param source   
+   * @param owner ,     .   
+   *  ,   . nullptr,    
+   *  
+   */
+  void Reset(const char* source, std::shared_ptr<MappedFile> owner = nullptr) {
+    source_ = source;
+    owner_ = std::move(owner);
+    types_.clear();
+    offsets_.clear();
+    lengths_.clear();
+    lines_.clear();
+    symbols_.clear();
+    symbol_table_.Clear();
+  }
+  /*!
+   * @brief     
+   * @param type  
+   * @param begin        
+   * @param end        
+   * @param line ,    
+   */
+  void Push(LexemeTypes type, const char* begin, const char* end, int line) {
+    types_.push_back(static_cast<int8_t>(type));
+    offsets_.push_back(static_cast<uint32_t>(begin - source_));
+    lengths_.push_back(static_cast<uint32_t>(end - begin));
+    lines_.push_back(line);
+  }
+  /*!
+   * @brief       
+   * @param other      
+   * @param line_offset       other
+   */
+  void Append(const TokenBuffer& other, int line_offset) {
+    types_.insert(types_.end(), other.types_.begin(), other.types_.end());
+    offsets_.insert(offsets_.end(), other.offsets_.begin(),
+                    other.offsets_.end());
+    lengths_.insert(lengths_.end(), other.lengths_.begin(),
+                    other.lengths_.end());
+    for (uint32_t line : other.lines_) lines_.push_back(line + line_offset);
+  }
+  /*!
+   * @brief     
+   *
+   *   ,     .  
+   *   -1
+   */
+  void InternSymbols() {
+    symbols_.resize(size());
+    for (size_t i = 0; i < size(); ++i) {
+      symbols_[i] = type(i) == LexemeTypes::Id ? symbol_table_.Intern(text(i))
+                                               : -1;
+    }
+  }
+  /*!
+   * @brief    
+   */
+  size_t size() const { return types_.size(); }
+  /*!
+   * @brief     ind
+   */
+  LexemeTypes type(size_t ind) const {
+    return static_cast<LexemeTypes>(types_[ind]);
+  }
+  /*!
+   * @brief     ind
+   */
+  std::string_view text(size_t ind) const {
+    return std::string_view(source_ + offsets_[ind], lengths_[ind]);
+  }
+  /*!
+   * @brief ,       ind
+   */
+  int line(size_t ind) const { return lines_[ind]; }
+  /*!
+   * @brief     ind, -1    
+   */
+  int symbol(size_t ind) const { return symbols_[ind]; }
+  /*!
+   * @brief  symbol_table_
+   * @return    
+   */
+  const SymbolTable& symbol_table() const { return symbol_table_; }
+  /*!
+   * @brief    
+   * @param ind  
+   * @return ,     .    
+   *    
+   */
+  Lexeme operator[](size_t ind) const {
+    if (ind >= size()) return Lexeme(LexemeTypes::Keyword, "", 0);
+    return Lexeme(type(ind), text(ind), line(ind), symbol(ind));
+  }
+
+ private:
+  const char* source_ = nullptr;  ///<   
+  std::shared_ptr<MappedFile> owner_;  ///<   ,    
+  std::vector<int8_t> types_;  ///<  
+  std::vector<uint32_t> offsets_;  ///<     
+  std::vector<uint32_t> lengths_;  ///<  
+  std::vector<uint32_t> lines_;  ///<  
+  std::vector<int32_t> symbols_;  ///<  
+  SymbolTable symbol_table_;  ///<   
+};
@@ -0,0 +1,187 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "Poliz.h"
+#include "SymbolTable.h"
+/*!
+ * \file
+ * \brief    ,     
+ */
+
+//!   
+enum class BaseTypes : uint8_t {
+  Int,     ///< int
+  Char,    ///< char
+  Float,   ///< float
+  Bool,    ///< bool
+  String,  ///< string
+  Void,    ///< void
+  Struct,  ///< ,     TypeDesc::symbol
+  Oper,    ///<  ,     ,     TypeDesc::symbol
+  Count
+};
+
+//!   
+enum class ValueKinds : uint8_t {
+  Value,   ///<  
+  Lvalue,  ///< ,    
+  List,    ///< 
+  Count
+};
+
+//! ,    
+enum Opers {
+  OpIndex,        ///< []
+  OpDot,          ///< .
+  OpInc,          ///< ++
+  OpDec,          ///< --
+  OpNot,          ///< !
+  OpPow,          ///< **
+  OpDiv,          ///< /
+  OpMul,          ///< *
+  OpMod,          ///< %
+  OpAdd,          ///< +
+  OpSub,          ///< -
+  OpLess,         ///< <
+  OpGreater,      ///< >
+  OpLessEq,       ///< <=
+  OpGreaterEq,    ///< >=
+  OpEq,           ///< ==
+  OpNe,           ///< !=
+  OpAnd,          ///< &&
+  OpOr,           ///< ||
+  OpXor,          ///< ^
+  OpAddAssign,    ///< +=
+  OpMulAssign,    ///< *=
+  OpAssign,       ///< =
+  OpSubAssign,    ///< -=
+  OpDivAssign,    ///< /=
+  OpModAssign,    ///< %=
+  OpComma,        ///< ,
+  OpersCount
+};
+
+//!     Opers
+constexpr std::string_view kOperNames[OpersCount] = {
+    "[]", ".",  "++", "--", "!",  "**", "/",  "*",  "%",
+    "+",  "-",  "<",  ">",  "<=", ">=", "==", "!=", "&&",
+    "||", "^",  "+=", "*=", "=",  "-=", "/=", "%=", ","};
+
+/*!
+ * @brief     Opers
+ * @param text  
+ * @return    OpersCount,    
+ */
+inline Opers ToOper(std::string_view text) {
+  for (int i = 0; i < OpersCount; ++i) {
+    if (kOperNames[i] == text) return static_cast<Opers>(i);
+  }
+  return OpersCount;
+}
+
+/*!
+ * \brief   
+ *
+ *   8 :  ,      .
+ *       
+ */
+struct TypeDesc {
+  /*!
+   * @brief     ,    
+   */
+  constexpr TypeDesc(BaseTypes base = BaseTypes::Void,
+                     ValueKinds kind = ValueKinds::Value, int symbol = -1)
+      : base(base), kind(kind), symbol(symbol) {}
+  /*!
+   * @brief    ,  
+   */
+  static constexpr TypeDesc Operation(Opers oper) {
+    return TypeDesc(BaseTypes::Oper, ValueKinds::Value, oper);
+  }
+  /*!
+   * @brief       
+   */
+  constexpr TypeDesc As(ValueKinds new_kind) const {
+    return TypeDesc(base, new_kind, symbol);
+  }
+
+  BaseTypes base;   ///<  
+  ValueKinds kind;  ///<  
+  int symbol;  ///<  ,    BaseTypes::Oper,  -1
+};
+
+inline bool operator==(const TypeDesc& lhs, const TypeDesc& rhs) {
+  return lhs.base == rhs.base && lhs.kind == rhs.kind &&
+         lhs.symbol == rhs.symbol;
+}
+inline bool operator!=(const TypeDesc& lhs, const TypeDesc& rhs) {
+  return !(lhs == rhs);
+}
+
+/*!
+ * @brief ,       
+ */
+constexpr bool IsStandardType(BaseTypes type) {
+  return type == BaseTypes::Int || type == BaseTypes::Bool ||
+         type == BaseTypes::String || type == BaseTypes::Float ||
+         type == BaseTypes::Char;
+}
+
+/*!
+ * @brief        TypeDesc
+ * @param name  
+ * @param symbol  ,    
+ * @return -   
+ */
+inline TypeDesc ToTypeDesc(std::string_view name, int symbol = -1) {
+  if (name == "int") return TypeDesc(BaseTypes::Int);
+  if (name == "char") return TypeDesc(BaseTypes::Char);
+  if (name == "float") return TypeDesc(BaseTypes::Float);
+  if (name == "bool") return TypeDesc(BaseTypes::Bool);
+  if (name == "string") return TypeDesc(BaseTypes::String);
+  if (name == "void") return TypeDesc(BaseTypes::Void);
+  return TypeDesc(BaseTypes::Struct, ValueKinds::Value, symbol);
+}
+
+/*!
+ * @brief      
+ * @param type 
+ * @return  .    - Bool
+ */
+inline VarTypes ToVarType(const TypeDesc& type) {
+  switch (type.base) {
+    case BaseTypes::Int:
+      return Int;
+    case BaseTypes::Char:
+      return Char;
+    case BaseTypes::Float:
+      return Float;
+    case BaseTypes::String:
+      return String;
+    default:
+      return Bool;
+  }
+}
+
+/*!
+ * @brief      
+ * @param type 
+ * @param symbols     
+ * @return     "a"    "l"  ,  
+ * 
+ */
+inline std::string ToString(const TypeDesc& type, const SymbolTable& symbols) {
+  static const char* kBaseNames[] = {"int",  "char", "float", "bool",
+                                     "string", "void"};
+  if (type.base == BaseTypes::Oper) {
+    return std::string(kOperNames[type.symbol]);
+  }
+  std::string res = type.kind == ValueKinds::Lvalue ? "a"
+                    : type.kind == ValueKinds::List ? "l"
+                                                    : "";
+  if (type.base == BaseTypes::Struct) {
+    return res + std::string(symbols.name(type.symbol));
+  }
+  return res + kBaseNames[static_cast<int>(type.base)];
+}
@@ -1,9 +1,12 @@
 #pragma once
+#include <cstdint>
 #include <stack>
 #include <string>
-#include <vector>
+#include <string_view>
 #include <exception>
 #include <stdexcept>
+#include "SymbolTable.h"
+#include "TypeDesc.h"
 /*!
 * \file
 * \brief     
@@ -11,16 +14,35 @@
 
 /*!
 * \brief   
-* 
-*         
+*
+*         .         .
+*
+*            ,       .   -      ,            
 */
 class TypeStack {
  public:
   /*!
-   * @brief    
-   * @param val   ,     
+   * @brief    
+   * @param symbols  ,         
   */
-  void Push(std::string val) { stack_.push(val); }
+  TypeStack(const SymbolTable& symbols) : symbols_(symbols) {}
+  /*!
+   * @brief    
+   * @param val ,     
+  */
+  void Push(TypeDesc val) { stack_.push(val); }
+  /*!
+   * @brief    
+   * @param oper  
+   * @throw std::invalid_argument    
+  */
+  void PushOper(std::string_view oper) {
+    Opers code = ToOper(oper);
+    if (code == OpersCount) {
+      throw std::invalid_argument("Unknown operation " + std::string(oper));
+    }
+    stack_.push(TypeDesc::Operation(code));
+  }
   /*!
    * @brief       
   */
@@ -32,98 +54,16 @@ class TypeStack {
     auto lhs = stack_.top();
     stack_.pop();
 
-    auto err = std::invalid_argument(
-        "Incompatible operands or operation: " + lhs + oper + rhs);
-
-    if (oper == "[]") {
-      if (lhs[0] != 'l' || rhs == "string" || rhs == "astring") {
-        throw err;
-      }
-      lhs.erase(lhs.begin());
-      Push("a" + lhs);
-      return;
-    }
-
-    if (lhs[0] == 'l' || rhs[0] == 'l') throw err;
-
-    if (oper.find("=") != oper.npos && oper != "==" && oper != "!=" &&
-        oper != ">=" && oper != "<=") {
-      if (rhs[0] == 'a') rhs.erase(rhs.begin());
-      if (lhs[0] == 'a') {
-        lhs.erase(lhs.begin());
-        if (lhs == "string" && rhs == "float" ||
-            lhs != "string" && rhs == "string" ||
-            (lhs == "string" && oper != "=" && oper != "+=")) {
-          throw err;
-        }
-        if (!IsStandardType(lhs) && lhs != rhs && oper != "=") {
-          throw err;
-        }
-      } else {
-        throw err;
-      }
-      Push("a" + lhs);
-      return;
-    }
-
-    if (oper == ",") {
-      Push(rhs);
-      return;
-    }
-
-    if (!IsStandardType(lhs) || !IsStandardType(rhs)) throw err;
-
-    if (rhs[0] == 'a') rhs.erase(rhs.begin());
-    if (lhs[0] == 'a') lhs.erase(lhs.begin());
-
-    if (oper == "&&" || oper == "||") {
-      if (lhs == "string" || rhs == "string" || lhs == "float" ||
-          rhs == "float") {
-        throw err;
-      }
-      Push("bool");
-      return;
-    }
-
-    if (oper == "==" || oper == "!=" || oper == ">" || oper == "<" ||
-        oper == ">=" || oper == "<=") {
-      if (rhs == "string" && lhs == "float" ||
-          rhs == "float" && lhs == "string") {
-        throw err;
-      }
-      Push("bool");
-      return;
-    }
-
-    if (oper == "+" || oper == "-") {
-      if (rhs == "string" && lhs == "float" ||
-          rhs == "float" && lhs == "string") {
-        throw err;
-      }
-      if (rhs == "string" || lhs == "string") {
-        Push("string");
-      } else if (lhs == "float" || rhs == "float") {
-        Push("float");
-      } else {
-        Push("int");
-      }
-      return;
+    uint8_t res = GetTables().bin[OperCode(oper)][Code(lhs)][Code(rhs)];
+    if (res == kLhsLvalueIfSame) {
+      res = lhs.base == rhs.base && lhs.symbol == rhs.symbol ? kLhsLvalue
+                                                             : kError;
     }
-
-    if (oper == "*" || oper == "/" || oper == "%" || oper == "**") {
-      if (rhs == "string" || lhs == "string") {
-        throw err;
-      }
-
-      if (lhs == "float" || rhs == "float") {
-        Push("float");
-      } else {
-        Push("int");
-      }
-      return;
+    if (res == kError) {
+      throw std::invalid_argument("Incompatible operands or operation: " +
+                                  Name(lhs) + Name(oper) + Name(rhs));
     }
-
-    throw err;
+    Push(Result(res, lhs, rhs));
   }
   /*!
    * @brief       
@@ -134,21 +74,12 @@ class TypeStack {
     auto lhs = stack_.top();
     stack_.pop();
 
-    auto err = std::invalid_argument("Incompatible operands or operation: " + lhs + oper);
-
-    if (lhs[0] == 'l' ||!IsStandardType(lhs)) throw err;
-
-    if ((lhs[0] != 'a' && (oper == "++" || oper == "--")) || lhs == "string" ||
-        lhs == "astring" || (oper=="!" && (lhs == "float" || lhs == "afloat"))) {
-      throw err;
-    }
-
-    if (oper == "++" || oper == "--") {
-      Push(lhs);
-    } else {
-      if (lhs[0] == 'a') lhs.erase(lhs.begin());
-      Push(lhs);
+    uint8_t res = GetTables().uno_r[OperCode(oper)][Code(lhs)];
+    if (res == kError) {
+      throw std::invalid_argument("Incompatible operands or operation: " +
+                                  Name(lhs) + Name(oper));
     }
+    Push(Result(res, lhs, lhs));
   }
   /*!
    * @brief       
@@ -159,20 +90,12 @@ class TypeStack {
     auto oper = stack_.top();
     stack_.pop();
 
-    auto err = std::invalid_argument("Incompatible operands or operation: " + oper + rhs);
-
-    if (rhs[0] == 'l' || !IsStandardType(rhs)) throw err;
-
-    if ((rhs[0] != 'a' && (oper == "++" || oper == "--")) || rhs == "string" ||
-        rhs == "astring") {
-      throw err;
-    }
-
-    if (oper == "!") {
-      Push("bool");
-    } else {
-      Push(rhs);
+    uint8_t res = GetTables().uno_l[OperCode(oper)][Code(rhs)];
+    if (res == kError) {
+      throw std::invalid_argument("Incompatible operands or operation: " +
+                                  Name(oper) + Name(rhs));
     }
+    Push(Result(res, rhs, rhs));
   }
   /*!
    * @brief ,           
@@ -180,7 +103,7 @@ class TypeStack {
   void CheckBool() {
     auto val = stack_.top();
     stack_.pop();
-    if (val == "string" || val == "astring" || val[0] == 'l') {
+    if (val.kind == ValueKinds::List || val.base == BaseTypes::String) {
       throw std::invalid_argument("Value is expected to be bool convertable");
     }
   }
@@ -188,25 +111,200 @@ class TypeStack {
    * @brief     
    * @return    
   */
-  std::string Top() const { return stack_.top(); }
+  TypeDesc Top() const { return stack_.top(); }
   /*!
    * @brief     
   */
   void Pop() { stack_.pop(); }
+  /*!
+   * @brief      
+   * @param type 
+   * @return     ,      
+  */
+  std::string Name(const TypeDesc& type) const {
+    return ToString(type, symbols_);
+  }
 
  private:
-  std::stack<std::string> stack_; ///< 
+  //!   :     
+  static constexpr int kCodes =
+      static_cast<int>(BaseTypes::Count) * static_cast<int>(ValueKinds::Count);
+  //!     ,    
+  static constexpr int kNotOper = OpersCount;
+
   /*!
-   * @brief ,      
-   * @param type ,   
-   * @return true  false 
+   * @brief   .   kCodes -  -
   */
-  bool IsStandardType(std::string type) {
-    if (type[0] == 'a' || type[0] == 'l') type.erase(type.begin());
-    if (type != "int" && type != "bool" && type != "string" &&
-        type != "float" && type != "char") {
-      return false;
+  static constexpr uint8_t kError = 255;  ///<  
+  static constexpr uint8_t kLhs = 254;  ///<  -    
+  static constexpr uint8_t kRhs = 253;  ///<  -    
+  static constexpr uint8_t kLhsLvalue = 252;  ///<  -    
+  static constexpr uint8_t kLhsLvalueIfSame = 251;  ///<  ,    ,  
+
+  /*!
+   * @brief   
+  */
+  struct Tables {
+    uint8_t bin[OpersCount + 1][kCodes][kCodes];  ///<  
+    uint8_t uno_l[OpersCount + 1][kCodes];  ///<   
+    uint8_t uno_r[OpersCount + 1][kCodes];  ///<   
+  };
+
+  /*!
+   * @brief     
+   * @return  
+  */
+  static const Tables& GetTables() {
+    static const Tables tables = BuildTables();
+    return tables;
+  }
+
+  static Tables BuildTables() {
+    Tables t;
+    for (int oper = 0; oper <= OpersCount; ++oper) {
+      for (int lhs = 0; lhs < kCodes; ++lhs) {
+        for (int rhs = 0; rhs < kCodes; ++rhs) {
+          t.bin[oper][lhs][rhs] = BinRule(oper, Decode(lhs), Decode(rhs));
+        }
+        t.uno_l[oper][lhs] = UnoLRule(oper, Decode(lhs));
+        t.uno_r[oper][lhs] = UnoRRule(oper, Decode(lhs));
+      }
     }
-    return true;
+    return t;
   }
+
+  static int Code(const TypeDesc& type) {
+    return static_cast<int>(type.base) * static_cast<int>(ValueKinds::Count) +
+           static_cast<int>(type.kind);
+  }
+  static TypeDesc Decode(int code) {
+    return TypeDesc(
+        static_cast<BaseTypes>(code / static_cast<int>(ValueKinds::Count)),
+        static_cast<ValueKinds>(code % static_cast<int>(ValueKinds::Count)));
+  }
+  static int OperCode(const TypeDesc& oper) {
+    return oper.base == BaseTypes::Oper ? oper.symbol : kNotOper;
+  }
+  static uint8_t Value(BaseTypes base) { return Code(TypeDesc(base)); }
+
+  /*!
+   * @brief  -    
+  */
+  static TypeDesc Result(uint8_t res, const TypeDesc& lhs, const TypeDesc& rhs) {
+    switch (res) {
+      case kLhs:
+        return lhs;
+      case kRhs:
+        return rhs;
+      case kLhsLvalue:
+        return lhs.As(ValueKinds::Lvalue);
+      default:
+        return Decode(res);
+    }
+  }
+
+  /*!
+   * @brief    
+   * @param oper    kNotOper
+   * @param lhs   
+   * @param rhs   
+   * @return   
+  */
+  static uint8_t BinRule(int oper, TypeDesc lhs, TypeDesc rhs) {
+    BaseTypes l = lhs.base, r = rhs.base;
+    if (oper == OpIndex) {
+      if (lhs.kind != ValueKinds::List ||
+          (r == BaseTypes::String && rhs.kind != ValueKinds::List)) {
+        return kError;
+      }
+      return kLhsLvalue;
+    }
+
+    if (lhs.kind == ValueKinds::List || rhs.kind == ValueKinds::List) {
+      return kError;
+    }
+
+    if (oper == OpAssign || oper == OpAddAssign || oper == OpSubAssign ||
+        oper == OpMulAssign || oper == OpDivAssign || oper == OpModAssign) {
+      if (lhs.kind != ValueKinds::Lvalue) return kError;
+      if ((l == BaseTypes::String && r == BaseTypes::Float) ||
+          (l != BaseTypes::String && r == BaseTypes::String) ||
+          (l == BaseTypes::String && oper != OpAssign &&
+           oper != OpAddAssign)) {
+        return kError;
+      }
+      if (!IsStandardType(l) && oper != OpAssign) {
+        return l == r ? kLhsLvalueIfSame : kError;
+      }
+      return kLhsLvalue;
+    }
+
+    if (oper == OpComma) return kRhs;
+
+    if (!IsStandardType(l) || !IsStandardType(r)) return kError;
+
+    bool strings = l == BaseTypes::String || r == BaseTypes::String;
+    bool floats = l == BaseTypes::Float || r == BaseTypes::Float;
+    bool string_float = strings && floats;
+
+    switch (oper) {
+      case OpAnd:
+      case OpOr:
+        return (strings || floats) ? kError : Value(BaseTypes::Bool);
+      case OpEq:
+      case OpNe:
+      case OpLess:
+      case OpGreater:
+      case OpLessEq:
+      case OpGreaterEq:
+        return string_float ? kError : Value(BaseTypes::Bool);
+      case OpAdd:
+      case OpSub:
+        if (string_float) return kError;
+        return Value(strings  ? BaseTypes::String
+                     : floats ? BaseTypes::Float
+                              : BaseTypes::Int);
+      case OpMul:
+      case OpDiv:
+      case OpMod:
+      case OpPow:
+        if (strings) return kError;
+        return Value(floats ? BaseTypes::Float : BaseTypes::Int);
+      default:
+        return kError;
+    }
+  }
+
+  /*!
+   * @brief     
+  */
+  static uint8_t UnoRRule(int oper, TypeDesc lhs) {
+    if (lhs.kind == ValueKinds::List || !IsStandardType(lhs.base)) {
+      return kError;
+    }
+    bool step = oper == OpInc || oper == OpDec;
+    if ((lhs.kind != ValueKinds::Lvalue && step) ||
+        lhs.base == BaseTypes::String ||
+        (oper == OpNot && lhs.base == BaseTypes::Float)) {
+      return kError;
+    }
+    return step ? kLhs : Value(lhs.base);
+  }
+
+  /*!
+   * @brief     
+  */
+  static uint8_t UnoLRule(int oper, TypeDesc rhs) {
+    if (rhs.kind == ValueKinds::List || !IsStandardType(rhs.base)) {
+      return kError;
+    }
+    if ((rhs.kind != ValueKinds::Lvalue && (oper == OpInc || oper == OpDec)) ||
+        rhs.base == BaseTypes::String) {
+      return kError;
+    }
+    return oper == OpNot ? Value(BaseTypes::Bool) : kLhs;
+  }
+
+  std::stack<TypeDesc> stack_; ///< 
+  const SymbolTable& symbols_; ///<      
 };